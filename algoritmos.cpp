@@ -4,6 +4,8 @@
 #include <gmpxx.h>
 #include <gmp.h>
 
+#include "pool_primos.hpp"
+
 
 mpz_class mdc_estendido(mpz_class &x, mpz_class &y, mpz_class a, mpz_class b)
 {
@@ -59,6 +61,13 @@ bool inverso_modular(mpz_class &r, mpz_class a, mpz_class n)
     return true;
 }
 
+mpz_class mult_modular(const mpz_class &a, const mpz_class &b, const mpz_class &n)
+{
+    // retorna a * b (mod n). é a multiplicação usada a cada passo de exp_binaria
+    // e das outras rotinas que trabalham módulo n.
+    return (a * b) % n;
+}
+
 mpz_class exp_binaria(mpz_class b, mpz_class e, mpz_class n)
 {
     /* calcula b^e (mod n) de forma rápida usando a decomposição do expoente e 
@@ -70,10 +79,10 @@ mpz_class exp_binaria(mpz_class b, mpz_class e, mpz_class n)
 
     while (E != 0) {
         if(E % 2 == 1) {
-            P = (A * P) % n;
+            P = mult_modular(A, P, n);
         }
         E /= 2;
-        A = (A * A) % n;
+        A = mult_modular(A, A, n);
     }
     return P;
 }
@@ -184,11 +193,12 @@ mpz_class primo_aleatorio(unsigned int b, gmp_randclass &rnd)
 void gera_chaves(mpz_class &n, mpz_class &e, mpz_class &d, gmp_randclass &rnd)
 {
     // gera chaves publica (n, e) e privada (n, e)
+    // os primos vêm do pool (se iniciado e não vazio); senão são gerados na hora.
     mpz_class p, q, totiente;
     int ok;
 
-    p = primo_aleatorio(2048, rnd);
-    q = primo_aleatorio(2048, rnd);
+    if (!retira_primo_pool(p, 2048, false)) p = primo_aleatorio(2048, rnd);
+    if (!retira_primo_pool(q, 2048, false)) q = primo_aleatorio(2048, rnd);
     n = p * q;
     totiente = (p - 1) * (q - 1);
     e = 65536;
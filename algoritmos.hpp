@@ -6,6 +6,8 @@ mpz_class mdc_estendido(mpz_class&, mpz_class&, mpz_class, mpz_class);
 
 bool inverso_modular(mpz_class&, mpz_class, mpz_class);
 
+mpz_class mult_modular(const mpz_class&, const mpz_class&, const mpz_class&);
+
 mpz_class exp_binaria(mpz_class, mpz_class, mpz_class);
 
 void pre_teste_miller(mpz_class, mpz_class&, unsigned int&, mpz_class&);
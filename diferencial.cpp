@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "algoritmos.hpp"
+#include "vetores.hpp"
+
+/* Teste diferencial das funções de algoritmos.hpp contra a GMP. O trabalho é
+dividido em shards independentes; cada shard tem uma semente própria derivada
+da semente global, e dentro dele cada (função, bitagem) tem seu próprio
+gerador, de forma que qualquer divergência pode ser reproduzida isoladamente
+com --semente-shard, --funcao e --bits. Os shards são distribuídos entre as
+threads. Com --gravar, os vetores verificados são gravados no formato de
+vetores.cpp, um arquivo por (função, bitagem, shard).
+
+Os domínios seguem o que cada função aceita hoje: mdc_estendido e
+inverso_modular não aceitam zero, exp_binaria exige n >= 2 e teste_miller
+exige n ímpar >= 3. */
+
+#define N_BORDA 8       // os primeiros casos de cada bitagem são de borda
+#define MAX_RELATOS 10  // divergências impressas por (função, bitagem, shard)
+
+typedef bool (*verificador)(gmp_randclass&, unsigned int, unsigned long, mpz_class*, std::string&);
+
+struct funcao_diferencial {
+    const char *nome;
+    unsigned int campos;    // inteiros gravados por vetor
+    unsigned int bits_min, bits_max;
+    unsigned int peso;      // caso custe caro, roda casos / peso vezes
+    bool lenta;             // só roda com --lentas ou --funcao
+    verificador verifica;
+};
+
+struct opcoes {
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned long shards = 0, casos = 1000;
+    uint64_t semente = 0, semente_shard = 0;
+    bool usa_semente_shard = false, lentas = false;
+    std::string funcao, gravar;
+    std::vector<unsigned int> bits = {8, 32, 64, 100, 256, 1024, 2048};
+};
+
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static std::string hex(const mpz_class &x)
+{
+    return (x < 0 ? "-0x" : "0x") + mpz_class(abs(x)).get_str(16);
+}
+
+static mpz_class operando(gmp_randclass &rnd, unsigned int bits, unsigned long caso, unsigned int qual,
+                          const mpz_class &minimo)
+{
+    // valores de borda nos primeiros casos (cada operando percorre a lista com
+    // uma defasagem diferente), depois valores aleatórios de até bits bits.
+    mpz_class x, topo = (mpz_class(1) << bits);
+
+    if (caso < N_BORDA) {
+        switch ((caso + 3 * qual) % 6) {
+            case 0: x = minimo; break;
+            case 1: x = minimo + 1; break;
+            case 2: x = topo - 1; break;
+            case 3: x = topo >> 1; break;
+            case 4: x = (topo >> 1) + 1; break;
+            default: x = topo - 2; break;
+        }
+    } else {
+        x = rnd.get_z_bits(bits);
+    }
+    return x < minimo ? minimo : x;
+}
+
+static bool primo_referencia(const mpz_class &n)
+{
+    return n >= 2 && mpz_probab_prime_p(n.get_mpz_t(), 30) != 0;
+}
+
+static bool verifica_mdc_estendido(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                   std::string &erro)
+{
+    mpz_class a = operando(rnd, bits, caso, 0, 1), b = operando(rnd, bits, caso, 1, 1), x, y, g, xr, yr, gr;
+
+    mpz_gcdext(gr.get_mpz_t(), xr.get_mpz_t(), yr.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+    g = mdc_estendido(x, y, a, b);
+    v[0] = a; v[1] = b; v[2] = xr; v[3] = yr; v[4] = gr;
+    if (g == gr && x * a + y * b == g) return true;
+    erro = "mdc_estendido(" + hex(a) + ", " + hex(b) + ") = " + hex(g) + " com x = " + hex(x) + ", y = "
+        + hex(y) + "; esperado mdc " + hex(gr);
+    return false;
+}
+
+static bool verifica_inverso_modular(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                     std::string &erro)
+{
+    mpz_class a = operando(rnd, bits, caso, 0, 1), n = operando(rnd, bits, caso, 1, 2), r, rr;
+    bool tem, tem_r;
+
+    tem_r = mpz_invert(rr.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t()) != 0;
+    if (!tem_r) rr = 0;
+    tem = inverso_modular(r, a, n);
+    v[0] = a; v[1] = n; v[2] = rr;
+    if (tem == tem_r && (!tem || r == rr)) return true;
+    erro = "inverso_modular(" + hex(a) + ", " + hex(n) + ") = " + (tem ? hex(r) : "nenhum") + "; esperado "
+        + (tem_r ? hex(rr) : "nenhum");
+    return false;
+}
+
+static bool verifica_potencia(mpz_class (*f)(mpz_class, mpz_class, mpz_class), const char *nome,
+                              gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                              std::string &erro)
+{
+    mpz_class b = operando(rnd, bits, caso, 0, 0), e = operando(rnd, bits, caso, 1, 0),
+              n = operando(rnd, bits, caso, 2, 2), r, rr;
+
+    mpz_powm(rr.get_mpz_t(), b.get_mpz_t(), e.get_mpz_t(), n.get_mpz_t());
+    r = f(b, e, n);
+    v[0] = b; v[1] = e; v[2] = n; v[3] = rr;
+    if (r == rr) return true;
+    erro = std::string(nome) + "(" + hex(b) + ", " + hex(e) + ", " + hex(n) + ") = " + hex(r) + "; esperado "
+        + hex(rr);
+    return false;
+}
+
+static bool verifica_mult_modular(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                  std::string &erro)
+{
+    mpz_class a = operando(rnd, bits, caso, 0, 0), b = operando(rnd, bits, caso, 1, 0),
+              n = operando(rnd, bits, caso, 2, 1), r, rr;
+
+    mpz_mul(rr.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+    mpz_mod(rr.get_mpz_t(), rr.get_mpz_t(), n.get_mpz_t());
+    r = mult_modular(a, b, n);
+    v[0] = a; v[1] = b; v[2] = n; v[3] = rr;
+    if (r == rr) return true;
+    erro = "mult_modular(" + hex(a) + ", " + hex(b) + ", " + hex(n) + ") = " + hex(r) + "; esperado " + hex(rr);
+    return false;
+}
+
+static bool verifica_exp_binaria(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                 std::string &erro)
+{
+    return verifica_potencia(exp_binaria, "exp_binaria", rnd, bits, caso, v, erro);
+}
+
+static bool verifica_criptografa(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                 std::string &erro)
+{
+    // criptografa(M, n, e) = M**e % n: a ordem dos argumentos difere de exp_binaria
+    return verifica_potencia([](mpz_class m, mpz_class e, mpz_class n) { return criptografa(m, n, e); },
+                             "criptografa", rnd, bits, caso, v, erro);
+}
+
+static bool verifica_descriptografa(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                    std::string &erro)
+{
+    return verifica_potencia([](mpz_class c, mpz_class d, mpz_class n) { return descriptografa(c, n, d); },
+                             "descriptografa", rnd, bits, caso, v, erro);
+}
+
+static mpz_class impar_minimo_3(gmp_randclass &rnd, unsigned int bits, unsigned long caso, unsigned int qual)
+{
+    mpz_class n = operando(rnd, bits, caso, qual, 3);
+    return n | 1;
+}
+
+static bool verifica_pre_teste_miller(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                      std::string &erro)
+{
+    mpz_class n = impar_minimo_3(rnd, bits, caso, 0), n1, q, n1r = n - 1, qr;
+    unsigned int k, kr = mpz_scan1(n1r.get_mpz_t(), 0);
+
+    qr = n1r >> kr;
+    pre_teste_miller(n, n1, k, q);
+    v[0] = n; v[1] = kr; v[2] = qr;
+    if (n1 == n1r && k == kr && q == qr) return true;
+    erro = "pre_teste_miller(" + hex(n) + ") = (" + hex(n1) + ", " + std::to_string(k) + ", " + hex(q)
+        + "); esperado (" + hex(n1r) + ", " + std::to_string(kr) + ", " + hex(qr) + ")";
+    return false;
+}
+
+static bool verifica_teste_miller(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                  std::string &erro)
+{
+    // referência: o mesmo teste de Miller escrito com mpz_powm
+    mpz_class n = impar_minimo_3(rnd, bits, caso, 0), b = operando(rnd, bits, caso, 1, 1), n1 = n - 1, q, r;
+    unsigned int k = mpz_scan1(n1.get_mpz_t(), 0);
+    bool res, res_r = false;
+
+    q = n1 >> k;
+    if (b % n == 0) {
+        res_r = true;
+    } else {
+        mpz_powm(r.get_mpz_t(), b.get_mpz_t(), q.get_mpz_t(), n.get_mpz_t());
+        res_r = r == 1 || r == n1;
+        for (unsigned int i = 1; i < k && !res_r; i++) {
+            r = r * r % n;
+            res_r = r == n1;
+        }
+    }
+    res = teste_miller(b, n, n1, k, q);
+    v[0] = b; v[1] = n; v[2] = res_r;
+    if (res == res_r) return true;
+    erro = "teste_miller(" + hex(b) + ", " + hex(n) + ") = " + std::to_string(res) + "; esperado "
+        + std::to_string(res_r);
+    return false;
+}
+
+static bool verifica_primalidade(bool (*f)(mpz_class), const char *nome, gmp_randclass &rnd, unsigned int bits,
+                                 unsigned long caso, mpz_class *v, std::string &erro)
+{
+    mpz_class n = operando(rnd, bits, caso, 0, 0);
+    bool res = f(n), res_r = primo_referencia(n);
+
+    v[0] = n; v[1] = res_r;
+    if (res == res_r) return true;
+    erro = std::string(nome) + "(" + hex(n) + ") = " + std::to_string(res) + "; esperado " + std::to_string(res_r);
+    return false;
+}
+
+static bool verifica_primo_simples(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                   std::string &erro)
+{
+    return verifica_primalidade(primo_simples, "primo_simples", rnd, bits, caso, v, erro);
+}
+
+static bool verifica_primo_fermat(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                  std::string &erro)
+{
+    return verifica_primalidade(primo_fermat, "primo_fermat", rnd, bits, caso, v, erro);
+}
+
+static bool verifica_primo_miller_rabin(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                                        std::string &erro)
+{
+    mpz_class n = operando(rnd, bits, caso, 0, 0);
+    bool res = primo_miller_rabin(n, 20, rnd), res_r = primo_referencia(n);
+
+    v[0] = n; v[1] = res_r;
+    if (res == res_r) return true;
+    erro = "primo_miller_rabin(" + hex(n) + ", 20) = " + std::to_string(res) + "; esperado " + std::to_string(res_r);
+    return false;
+}
+
+static bool verifica_primo_aleatorio(gmp_randclass &rnd, unsigned int bits, unsigned long, mpz_class *v,
+                                     std::string &erro)
+{
+    mpz_class p = primo_aleatorio(bits, rnd);
+
+    v[0] = bits; v[1] = p;
+    if (primo_referencia(p) && p < (mpz_class(1) << bits)) return true;
+    erro = "primo_aleatorio(" + std::to_string(bits) + ") = " + hex(p) + ", que nao e primo menor que 2^bits";
+    return false;
+}
+
+static bool verifica_gera_primo_seguro(gmp_randclass &rnd, unsigned int bits, unsigned long, mpz_class *v,
+                                       std::string &erro)
+{
+    mpz_class p = gera_primo_seguro(bits, rnd), q = (p - 1) / 2;
+
+    v[0] = bits; v[1] = p;
+    if (primo_referencia(p) && primo_referencia(q) && q < (mpz_class(1) << bits)) return true;
+    erro = "gera_primo_seguro(" + std::to_string(bits) + ") = " + hex(p) + ", que nao e primo seguro";
+    return false;
+}
+
+static bool verifica_codifica(gmp_randclass &rnd, unsigned int bits, unsigned long caso, mpz_class *v,
+                              std::string &erro)
+{
+    // mensagens ascii de até min(bits / 8, 499) caracteres: codifica deve ser o
+    // número de base 256 dos bytes e decodifica deve devolver a mensagem.
+    unsigned long tam = caso < N_BORDA ? caso : mpz_class(rnd.get_z_range(std::min(bits / 8, 499u) + 1)).get_ui();
+    std::string mensagem;
+    mpz_class M, Mr;
+    char *saida;
+    bool ok;
+
+    for (unsigned long i = 0; i < tam; i++) mensagem += char(1 + mpz_class(rnd.get_z_range(127)).get_ui());
+    mpz_import(Mr.get_mpz_t(), mensagem.size(), -1, 1, 0, 0, mensagem.data());
+    M = codifica(mensagem.c_str());
+    saida = decodifica(M);
+    ok = M == Mr && mensagem == saida;
+    free(saida);
+    v[0] = Mr;
+    if (ok) return true;
+    erro = "codifica/decodifica de mensagem com " + std::to_string(tam) + " caracteres: " + hex(M) + "; esperado "
+        + hex(Mr);
+    return false;
+}
+
+static bool verifica_gera_chaves(gmp_randclass &rnd, unsigned int, unsigned long, mpz_class *v, std::string &erro)
+{
+    // sem acesso a p e q, verifica que (e, d) invertem uma mensagem aleatória
+    mpz_class n, e, d, M, C, D;
+
+    gera_chaves(n, e, d, rnd);
+    M = rnd.get_z_range(n);
+    mpz_powm(C.get_mpz_t(), M.get_mpz_t(), e.get_mpz_t(), n.get_mpz_t());
+    mpz_powm(D.get_mpz_t(), C.get_mpz_t(), d.get_mpz_t(), n.get_mpz_t());
+    v[0] = n; v[1] = e; v[2] = d;
+    if (D == M) return true;
+    erro = "gera_chaves gerou n = " + hex(n) + ", e = " + hex(e) + ", d = " + hex(d) + " que nao inverte " + hex(M);
+    return false;
+}
+
+static const funcao_diferencial funcoes[] = {
+    {"mdc_estendido", 5, 1, 4096, 1, false, verifica_mdc_estendido},
+    {"inverso_modular", 3, 2, 4096, 1, false, verifica_inverso_modular},
+    {"mult_modular", 4, 1, 4096, 1, false, verifica_mult_modular},
+    {"exp_binaria", 4, 2, 4096, 1, false, verifica_exp_binaria},
+    {"criptografa", 4, 2, 4096, 1, false, verifica_criptografa},
+    {"descriptografa", 4, 2, 4096, 1, false, verifica_descriptografa},
+    {"pre_teste_miller", 3, 2, 4096, 1, false, verifica_pre_teste_miller},
+    {"teste_miller", 3, 2, 4096, 1, false, verifica_teste_miller},
+    {"primo_simples", 2, 1, 30, 1, false, verifica_primo_simples},
+    {"primo_fermat", 2, 1, 14, 10, false, verifica_primo_fermat},
+    {"primo_miller_rabin", 2, 1, 4096, 1, false, verifica_primo_miller_rabin},
+    {"primo_aleatorio", 2, 2, 512, 100, false, verifica_primo_aleatorio},
+    {"gera_primo_seguro", 2, 2, 64, 100, false, verifica_gera_primo_seguro},
+    {"codifica", 1, 8, 4096, 1, false, verifica_codifica},
+    {"gera_chaves", 3, 2048, 2048, 1000, true, verifica_gera_chaves},
+};
+
+#define N_FUNCOES (sizeof(funcoes) / sizeof(funcoes[0]))
+
+struct contagem {
+    std::atomic<unsigned long> casos{0}, divergencias{0};
+};
+
+static opcoes opc;
+static contagem contagens[N_FUNCOES];
+static std::atomic<unsigned long> proximo_shard(0);
+static std::mutex mutex_saida;
+
+static std::vector<unsigned int> bitagens(const funcao_diferencial &f)
+{
+    // as bitagens pedidas que cabem no domínio da função (ou o limite mais próximo)
+    std::vector<unsigned int> r;
+
+    for (unsigned int b : opc.bits) {
+        unsigned int c = std::min(std::max(b, f.bits_min), f.bits_max);
+        if (std::find(r.begin(), r.end(), c) == r.end()) r.push_back(c);
+    }
+    return r;
+}
+
+static bool selecionada(const funcao_diferencial &f)
+{
+    if (!opc.funcao.empty()) return opc.funcao == f.nome;
+    return !f.lenta || opc.lentas;
+}
+
+static void roda_shard(unsigned long shard, uint64_t semente_shard)
+{
+    gmp_randclass rnd(gmp_randinit_default);
+    mpz_class v[8];
+    std::string erro;
+
+    for (size_t i = 0; i < N_FUNCOES; i++) {
+        const funcao_diferencial &f = funcoes[i];
+        if (!selecionada(f)) continue;
+
+        for (unsigned int bits : bitagens(f)) {
+            unsigned long casos = std::max(1ul, opc.casos / f.peso), relatos = 0;
+            std::ofstream gravacao;
+
+            rnd.seed(splitmix64(semente_shard ^ (uint64_t(i) << 32) ^ bits));
+            if (!opc.gravar.empty()) {
+                gravacao.open(opc.gravar + "/" + f.nome + "." + std::to_string(bits) + "." + std::to_string(shard)
+                              + ".vet", std::ios::binary);
+                escreve_cabecalho_vetores(gravacao, f.campos);
+            }
+
+            for (unsigned long caso = 0; caso < casos; caso++) {
+                if (!f.verifica(rnd, bits, caso, v, erro)) {
+                    contagens[i].divergencias++;
+                    if (relatos++ < MAX_RELATOS) {
+                        std::lock_guard<std::mutex> trava(mutex_saida);
+                        std::cerr << "DIVERGENCIA em " << f.nome << " (bits = " << bits << ", shard = " << shard
+                            << ", caso = " << caso << "): " << erro << '\n'
+                            << "  reproduzir: ./diferencial.out --semente-shard 0x" << std::hex << semente_shard
+                            << std::dec << " --funcao " << f.nome << " --bits " << bits << " --casos "
+                            << (caso + 1) * f.peso << '\n';
+                    }
+                }
+                if (gravacao.is_open()) escreve_vetor(gravacao, v, f.campos);
+            }
+            contagens[i].casos += casos;
+        }
+    }
+}
+
+static void trabalhador()
+{
+    unsigned long shard;
+
+    while ((shard = proximo_shard++) < opc.shards) {
+        roda_shard(shard, splitmix64(opc.semente + shard));
+    }
+}
+
+static void uso()
+{
+    std::cerr << "uso: ./diferencial.out [--threads T] [--shards S] [--casos C] [--semente X]\n"
+                 "                        [--semente-shard X] [--funcao nome] [--bits b1,b2,...]\n"
+                 "                        [--gravar diretorio] [--lentas]\n";
+    exit(2);
+}
+
+static void le_opcoes(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (!strcmp(a, "--lentas")) { opc.lentas = true; continue; }
+        if (i + 1 >= argc) uso();
+        const char *v = argv[++i];
+        if (!strcmp(a, "--threads")) opc.threads = std::max(1ul, strtoul(v, nullptr, 0));
+        else if (!strcmp(a, "--shards")) opc.shards = strtoul(v, nullptr, 0);
+        else if (!strcmp(a, "--casos")) opc.casos = strtoul(v, nullptr, 0);
+        else if (!strcmp(a, "--semente")) opc.semente = strtoull(v, nullptr, 0);
+        else if (!strcmp(a, "--semente-shard")) { opc.semente_shard = strtoull(v, nullptr, 0); opc.usa_semente_shard = true; }
+        else if (!strcmp(a, "--funcao")) opc.funcao = v;
+        else if (!strcmp(a, "--gravar")) opc.gravar = v;
+        else if (!strcmp(a, "--bits")) {
+            std::stringstream ss(v);
+            std::string b;
+            opc.bits.clear();
+            while (std::getline(ss, b, ',')) opc.bits.push_back(std::stoul(b));
+        } else uso();
+    }
+    if (opc.shards == 0) opc.shards = opc.threads;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long total = 0, divergencias = 0;
+    std::vector<std::thread> threads;
+    double segundos;
+
+    le_opcoes(argc, argv);
+    auto inicio = std::chrono::steady_clock::now();
+
+    if (opc.usa_semente_shard) {
+        // reprodução de um único shard, na thread principal
+        roda_shard(0, opc.semente_shard);
+    } else {
+        std::clog << "Teste diferencial com semente = " << opc.semente << ", " << opc.shards << " shard(s) em "
+            << opc.threads << " thread(s)...\n";
+        for (unsigned int i = 0; i < opc.threads; i++) threads.emplace_back(trabalhador);
+        for (auto &t : threads) t.join();
+    }
+    segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    for (size_t i = 0; i < N_FUNCOES; i++) {
+        if (contagens[i].casos == 0) continue;
+        std::clog << funcoes[i].nome << ": " << contagens[i].casos << " caso(s), " << contagens[i].divergencias
+            << " divergencia(s)\n";
+        total += contagens[i].casos;
+        divergencias += contagens[i].divergencias;
+    }
+    std::clog << total << " caso(s) em " << segundos << " s (" << total / segundos << " casos/s), "
+        << divergencias << " divergencia(s).\n";
+    return divergencias != 0;
+}
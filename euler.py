@@ -45,11 +45,14 @@ def sumsq_naturals(n):
 	# returns the sum of the squares of the first n natural numbers
 	return (2 * n + 1) * (n + 1) * n // 6
 
-@lru_cache(maxsize=None)
 def fibonacci(n):
-	if n == 0: return 0
-	if n == 1: return 1
-	return fibonacci(n - 1) + fibonacci(n - 2)
+	# fast doubling: F(2k) = F(k)(2F(k+1) - F(k)) and F(2k+1) = F(k)**2 + F(k+1)**2.
+	# O(log n) steps and constant memory (see lucas.cpp for the C++ version).
+	a, b = 0, 1
+	for bit in bin(n)[2:]:
+		a, b = a * (2 * b - a), a * a + b * b
+		if bit == '1': a, b = b, a + b
+	return a
 
 def divide_until_not_multiple(n, factor):
 	while n % factor == 0:
@@ -192,7 +195,7 @@ def cfrac_sqrt(x):
 	a = a0
 	while a != 2 * a0:
 		m = d * a - m
-		d = (x - m * m) / d
+		d = (x - m * m) // d
 		a = (a0 + m) // d
 		period.append(a)
 	return a0, period
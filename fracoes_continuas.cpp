@@ -0,0 +1,165 @@
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "fracoes_continuas.hpp"
+
+/* Convergentes de frações contínuas por divisão binária (binary splitting).
+O convergente h(n)/k(n) de [a0; a1, ..., an] sai do produto de matrizes
+
+    | h(n)  h(n-1) |   | a0 1 |   | a1 1 |       | an 1 |
+    | k(n)  k(n-1) | = | 1  0 | * | 1  0 | * ... | 1  0 |
+
+que é calculado como uma árvore de produtos: as metades são multiplicadas
+recursivamente e só no fim os números grandes se encontram, o que aproveita a
+multiplicação rápida da GMP em vez de somar um termo por vez. As subárvores
+de cima são distribuídas entre threads. Nas funções com parâmetro threads, 0
+significa usar todos os núcleos. */
+
+#define FOLHA 32 // abaixo disso o produto é feito termo a termo
+
+struct matriz2 {
+    mpz_class a = 1, b = 0, c = 0, d = 1; // [[a, b], [c, d]], começa na identidade
+};
+
+static matriz2 multiplica(const matriz2 &x, const matriz2 &y)
+{
+    matriz2 r;
+
+    r.a = x.a * y.a + x.b * y.c;
+    r.b = x.a * y.b + x.b * y.d;
+    r.c = x.c * y.a + x.d * y.c;
+    r.d = x.c * y.b + x.d * y.d;
+    return r;
+}
+
+static matriz2 produto_sequencial(const mpz_class *termos, size_t tam)
+{
+    // multiplicar por | t 1 ; 1 0 | à direita é a recorrência h(i) = t h(i-1) + h(i-2)
+    matriz2 r;
+    mpz_class aux;
+
+    for (size_t i = 0; i < tam; i++) {
+        aux = r.a;
+        r.a = termos[i] * r.a + r.b;
+        r.b = aux;
+        aux = r.c;
+        r.c = termos[i] * r.c + r.d;
+        r.d = aux;
+    }
+    return r;
+}
+
+static matriz2 produto_termos(const mpz_class *termos, size_t tam, unsigned int threads)
+{
+    size_t meio = tam / 2;
+    matriz2 esq, dir;
+
+    if (tam <= FOLHA) return produto_sequencial(termos, tam);
+    if (threads > 1) {
+        std::thread t([&] { esq = produto_termos(termos, meio, threads / 2); });
+        dir = produto_termos(termos + meio, tam - meio, threads - threads / 2);
+        t.join();
+    } else {
+        esq = produto_termos(termos, meio, 1);
+        dir = produto_termos(termos + meio, tam - meio, 1);
+    }
+    return multiplica(esq, dir);
+}
+
+static unsigned int numero_threads(unsigned int threads)
+{
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+mpz_class fracao_continua_raiz(std::vector<mpz_class> &periodo, mpz_class x)
+{
+    // retorna a0 e preenche periodo com o período da fração contínua de
+    // sqrt(x) = [a0; periodo, periodo, ...]. se x é quadrado, o período é vazio.
+    mpz_class a0, a, m = 0, d = 1;
+
+    if (x < 0) throw std::invalid_argument("x deve ser maior ou igual a 0.");
+    periodo.clear();
+    mpz_sqrt(a0.get_mpz_t(), x.get_mpz_t());
+    if (a0 * a0 == x) return a0;
+
+    a = a0;
+    while (a != 2 * a0) {
+        m = d * a - m;
+        d = (x - m * m) / d;
+        a = (a0 + m) / d;
+        periodo.push_back(a);
+    }
+    return a0;
+}
+
+void convergente(mpz_class &h, mpz_class &k, const std::vector<mpz_class> &termos, unsigned int threads)
+{
+    // h/k é o convergente da fração contínua finita [termos[0]; termos[1], ...]
+    matriz2 M;
+
+    if (termos.empty()) throw std::invalid_argument("a fracao continua precisa de pelo menos um termo.");
+    M = produto_termos(termos.data(), termos.size(), numero_threads(threads));
+    h = M.a;
+    k = M.c;
+}
+
+void convergente_periodica(mpz_class &h, mpz_class &k, mpz_class a0, const std::vector<mpz_class> &periodo,
+                           unsigned long n, unsigned int threads)
+{
+    // h/k é o n-ésimo convergente de [a0; periodo, periodo, ...]. com n = q L + r
+    // (L o tamanho do período), o produto é M(a0) P^q M(primeiros r termos), onde
+    // P é o produto do período, elevado a q por exponenciação binária.
+    unsigned long q, r;
+    matriz2 M, P, potencia;
+
+    threads = numero_threads(threads);
+    M.a = a0; M.b = 1; M.c = 1; M.d = 0;
+    if (n == 0) { h = a0; k = 1; return; }
+    if (periodo.empty()) throw std::invalid_argument("fracao continua finita so tem o convergente 0.");
+
+    q = n / periodo.size();
+    r = n % periodo.size();
+    P = produto_termos(periodo.data(), periodo.size(), threads);
+    while (q != 0) {
+        if (q % 2 == 1) potencia = multiplica(potencia, P);
+        q /= 2;
+        if (q != 0) P = multiplica(P, P);
+    }
+    M = multiplica(multiplica(M, potencia), produto_termos(periodo.data(), r, threads));
+    h = M.a;
+    k = M.c;
+}
+
+void convergente_e(mpz_class &h, mpz_class &k, unsigned long n, unsigned int threads)
+{
+    // h/k é o n-ésimo convergente de e = [2; 1, 2, 1, 1, 4, 1, 1, 6, ...]
+    // (o mesmo de e_convergent(n) em euler.py)
+    std::vector<mpz_class> termos(n + 1, 1);
+
+    termos[0] = 2;
+    for (unsigned long i = 2; i <= n; i += 3) termos[i] = 2 * ((i + 1) / 3);
+    convergente(h, k, termos, threads);
+}
+
+bool solucao_pell(mpz_class &x, mpz_class &y, mpz_class D, unsigned int threads)
+{
+    // solução fundamental de x^2 - D y^2 = 1: é o convergente de índice L - 1
+    // de sqrt(D) se o período L for par, ou 2L - 1 se for ímpar.
+    // retorna false se D é um quadrado perfeito (só há a solução trivial).
+    std::vector<mpz_class> periodo;
+    mpz_class a0;
+    unsigned long L;
+
+    if (D <= 0) throw std::invalid_argument("D deve ser positivo.");
+    a0 = fracao_continua_raiz(periodo, D);
+    if (periodo.empty()) return false;
+
+    L = periodo.size();
+    convergente_periodica(x, y, a0, periodo, L % 2 == 0 ? L - 1 : 2 * L - 1, threads);
+    return true;
+}
@@ -0,0 +1,14 @@
+#include <vector>
+
+#include <gmpxx.h>
+
+mpz_class fracao_continua_raiz(std::vector<mpz_class>&, mpz_class);
+
+void convergente(mpz_class&, mpz_class&, const std::vector<mpz_class>&, unsigned int = 0);
+
+void convergente_periodica(mpz_class&, mpz_class&, mpz_class, const std::vector<mpz_class>&, unsigned long,
+                           unsigned int = 0);
+
+void convergente_e(mpz_class&, mpz_class&, unsigned long, unsigned int = 0);
+
+bool solucao_pell(mpz_class&, mpz_class&, mpz_class, unsigned int = 0);
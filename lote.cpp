@@ -0,0 +1,559 @@
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define LOTE_X86
+#include <immintrin.h>
+#endif
+
+#include "lote.hpp"
+
+/* Aritmética modular em lote para módulos de até 64 bits. Cada operação
+recebe vetores independentes (um módulo por posição) e os processa em blocos
+de 4 (AVX2) ou 8 (AVX-512 IFMA) candidatos por vez usando multiplicação de
+Montgomery. A implementação é escolhida em tempo de execução conforme a CPU;
+a versão escalar é usada quando não há suporte a SIMD. */
+
+__extension__ typedef unsigned __int128 u128;
+
+#define LARGURA_MAX 8
+
+struct kernel_lote {
+    const char *nome;
+    unsigned int largura; // quantos candidatos são processados por bloco
+    unsigned int bits_r;  // Montgomery com R = 2**bits_r; exige n < R
+    bool (*suportado)();
+    void (*mult)(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*,
+                 const uint64_t*, const uint64_t*);
+    void (*exp)(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*,
+                const uint64_t*, const uint64_t*);
+    void (*miller)(bool*, const uint64_t*, const uint64_t*, const uint64_t*,
+                   const uint64_t*, const uint64_t*, const uint64_t*);
+};
+
+static uint64_t mult_mod64(uint64_t a, uint64_t b, uint64_t n)
+{
+    return (u128) a * b % n;
+}
+
+static uint64_t exp_mod64(uint64_t b, uint64_t e, uint64_t n)
+{
+    // mesma exponenciação binária de exp_binaria, mas em palavras de 64 bits.
+    uint64_t A = b % n, P = 1 % n;
+
+    while (e != 0) {
+        if (e & 1) P = mult_mod64(A, P, n);
+        e >>= 1;
+        A = mult_mod64(A, A, n);
+    }
+    return P;
+}
+
+static uint64_t inverso_64(uint64_t n)
+{
+    // inverso de n ímpar mod 2**64 por Newton: cada passo dobra os bits corretos.
+    uint64_t x = n; // n * n = 1 (mod 8)
+    for (int i = 0; i < 5; i++) x *= 2 - n * x;
+    return x;
+}
+
+/* ---------------------------- versão escalar ---------------------------- */
+
+static inline uint64_t montgomery64(uint64_t a, uint64_t b, uint64_t n, uint64_t ninv)
+{
+    // retorna a * b * 2**-64 (mod n). m é escolhido de forma que m * n tenha a
+    // mesma palavra baixa de a * b, então a subtração das palavras altas é exata.
+    u128 t = (u128) a * b;
+    uint64_t m = (uint64_t) t * ninv;
+    uint64_t mh = ((u128) m * n) >> 64;
+    uint64_t hi = t >> 64;
+    return hi < mh ? hi - mh + n : hi - mh;
+}
+
+static uint64_t exp_montgomery64(uint64_t b, uint64_t e, uint64_t n, uint64_t ninv, uint64_t r2)
+{
+    // retorna b**e na forma de Montgomery
+    uint64_t A = montgomery64(b, r2, n, ninv),
+             P = montgomery64(1, r2, n, ninv);
+
+    while (e != 0) {
+        if (e & 1) P = montgomery64(A, P, n, ninv);
+        e >>= 1;
+        A = montgomery64(A, A, n, ninv);
+    }
+    return P;
+}
+
+static bool suportado_escalar() { return true; }
+
+static void mult_escalar(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n,
+                         const uint64_t *ninv, const uint64_t *r2)
+{
+    r[0] = montgomery64(montgomery64(a[0], b[0], n[0], ninv[0]), r2[0], n[0], ninv[0]);
+}
+
+static void exp_escalar(uint64_t *r, const uint64_t *b, const uint64_t *e, const uint64_t *n,
+                        const uint64_t *ninv, const uint64_t *r2)
+{
+    r[0] = montgomery64(exp_montgomery64(b[0], e[0], n[0], ninv[0], r2[0]), 1, n[0], ninv[0]);
+}
+
+static void miller_escalar(bool *r, const uint64_t *b, const uint64_t *q, const uint64_t *k,
+                           const uint64_t *n, const uint64_t *ninv, const uint64_t *r2)
+{
+    uint64_t um = montgomery64(1, r2[0], n[0], ninv[0]),
+             n1 = n[0] - um, // -1 na forma de Montgomery
+             x = exp_montgomery64(b[0], q[0], n[0], ninv[0], r2[0]);
+
+    r[0] = x == um || x == n1;
+    for (uint64_t i = 1; i < k[0] && !r[0]; i++) {
+        x = montgomery64(x, x, n[0], ninv[0]);
+        r[0] = x == n1;
+    }
+}
+
+#ifdef LOTE_X86
+
+/* ------------------------------ versão AVX2 ----------------------------- */
+
+/* AVX2 só multiplica 32x32 -> 64 bits, então o produto 64x64 -> 128 é montado
+a partir de quatro produtos parciais em cada uma das 4 posições. */
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static bool suportado_avx2() { return __builtin_cpu_supports("avx2"); }
+
+AVX2 static inline __m256i menor_avx2(__m256i a, __m256i b)
+{
+    // máscara de a < b sem sinal
+    const __m256i sinal = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sinal), _mm256_xor_si256(a, sinal));
+}
+
+AVX2 static inline void mult_completa_avx2(__m256i a, __m256i b, __m256i &lo, __m256i &hi)
+{
+    const __m256i mascara = _mm256_set1_epi64x(0xffffffff);
+    __m256i ah = _mm256_srli_epi64(a, 32),
+            bh = _mm256_srli_epi64(b, 32),
+            ll = _mm256_mul_epu32(a, b),
+            lh = _mm256_mul_epu32(a, bh),
+            hl = _mm256_mul_epu32(ah, b),
+            hh = _mm256_mul_epu32(ah, bh),
+            meio;
+
+    meio = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+           _mm256_add_epi64(_mm256_and_si256(lh, mascara), _mm256_and_si256(hl, mascara)));
+    lo = _mm256_or_si256(_mm256_and_si256(ll, mascara), _mm256_slli_epi64(meio, 32));
+    hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(lh, 32)),
+         _mm256_add_epi64(_mm256_srli_epi64(hl, 32), _mm256_srli_epi64(meio, 32)));
+}
+
+AVX2 static inline __m256i mult_baixa_avx2(__m256i a, __m256i b)
+{
+    // apenas os 64 bits baixos de a * b
+    __m256i cruzado = _mm256_add_epi64(_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+                                       _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cruzado, 32));
+}
+
+AVX2 static inline __m256i montgomery_avx2(__m256i a, __m256i b, __m256i n, __m256i ninv)
+{
+    __m256i lo, hi, m, mlo, mh, r;
+
+    mult_completa_avx2(a, b, lo, hi);
+    m = mult_baixa_avx2(lo, ninv);
+    mult_completa_avx2(m, n, mlo, mh);
+    r = _mm256_sub_epi64(hi, mh);
+    return _mm256_add_epi64(r, _mm256_and_si256(n, menor_avx2(hi, mh)));
+}
+
+AVX2 static inline __m256i exp_montgomery_avx2(__m256i b, __m256i e, __m256i n, __m256i ninv, __m256i r2)
+{
+    const __m256i um = _mm256_set1_epi64x(1);
+    __m256i A = montgomery_avx2(b, r2, n, ninv),
+            P = montgomery_avx2(um, r2, n, ninv),
+            bit;
+
+    // cada posição tem seu próprio expoente; o laço termina quando todos zeram.
+    while (!_mm256_testz_si256(e, e)) {
+        bit = _mm256_cmpeq_epi64(_mm256_and_si256(e, um), um);
+        P = _mm256_blendv_epi8(P, montgomery_avx2(A, P, n, ninv), bit);
+        e = _mm256_srli_epi64(e, 1);
+        A = montgomery_avx2(A, A, n, ninv);
+    }
+    return P;
+}
+
+AVX2 static void mult_avx2(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n,
+                           const uint64_t *ninv, const uint64_t *r2)
+{
+    __m256i N = _mm256_loadu_si256((const __m256i*) n),
+            I = _mm256_loadu_si256((const __m256i*) ninv),
+            x;
+
+    x = montgomery_avx2(_mm256_loadu_si256((const __m256i*) a), _mm256_loadu_si256((const __m256i*) b), N, I);
+    x = montgomery_avx2(x, _mm256_loadu_si256((const __m256i*) r2), N, I);
+    _mm256_storeu_si256((__m256i*) r, x);
+}
+
+AVX2 static void exp_avx2(uint64_t *r, const uint64_t *b, const uint64_t *e, const uint64_t *n,
+                          const uint64_t *ninv, const uint64_t *r2)
+{
+    __m256i N = _mm256_loadu_si256((const __m256i*) n),
+            I = _mm256_loadu_si256((const __m256i*) ninv),
+            x;
+
+    x = exp_montgomery_avx2(_mm256_loadu_si256((const __m256i*) b), _mm256_loadu_si256((const __m256i*) e),
+                            N, I, _mm256_loadu_si256((const __m256i*) r2));
+    x = montgomery_avx2(x, _mm256_set1_epi64x(1), N, I);
+    _mm256_storeu_si256((__m256i*) r, x);
+}
+
+AVX2 static void miller_avx2(bool *r, const uint64_t *b, const uint64_t *q, const uint64_t *k,
+                             const uint64_t *n, const uint64_t *ninv, const uint64_t *r2)
+{
+    __m256i N = _mm256_loadu_si256((const __m256i*) n),
+            I = _mm256_loadu_si256((const __m256i*) ninv),
+            R2 = _mm256_loadu_si256((const __m256i*) r2),
+            K = _mm256_loadu_si256((const __m256i*) k),
+            um = montgomery_avx2(_mm256_set1_epi64x(1), R2, N, I),
+            n1 = _mm256_sub_epi64(N, um),
+            x, res, ativo;
+    uint64_t kmax = 0, saida[4];
+
+    x = exp_montgomery_avx2(_mm256_loadu_si256((const __m256i*) b), _mm256_loadu_si256((const __m256i*) q), N, I, R2);
+    res = _mm256_or_si256(_mm256_cmpeq_epi64(x, um), _mm256_cmpeq_epi64(x, n1));
+    for (int i = 0; i < 4; i++) if (k[i] > kmax) kmax = k[i];
+    for (uint64_t i = 1; i < kmax; i++) {
+        x = montgomery_avx2(x, x, N, I);
+        ativo = _mm256_cmpgt_epi64(K, _mm256_set1_epi64x(i));
+        res = _mm256_or_si256(res, _mm256_and_si256(ativo, _mm256_cmpeq_epi64(x, n1)));
+    }
+    _mm256_storeu_si256((__m256i*) saida, res);
+    for (int i = 0; i < 4; i++) r[i] = saida[i] != 0;
+}
+
+/* -------------------------- versão AVX-512 IFMA -------------------------- */
+
+/* As instruções IFMA multiplicam 52x52 -> 104 bits diretamente, então esta
+versão usa R = 2**52 e só atende módulos menores que 2**52. Blocos com módulos
+maiores são desviados para a melhor versão de 64 bits disponível. */
+
+#define IFMA __attribute__((target("avx512f,avx512ifma")))
+
+IFMA static bool suportado_ifma()
+{
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+}
+
+IFMA static inline __m512i montgomery_ifma(__m512i a, __m512i b, __m512i n, __m512i ninv)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i lo = _mm512_madd52lo_epu64(zero, a, b),
+            hi = _mm512_madd52hi_epu64(zero, a, b),
+            m = _mm512_madd52lo_epu64(zero, lo, ninv),
+            mh = _mm512_madd52hi_epu64(zero, m, n),
+            r = _mm512_sub_epi64(hi, mh);
+    return _mm512_mask_add_epi64(r, _mm512_cmplt_epu64_mask(hi, mh), r, n);
+}
+
+IFMA static inline __m512i exp_montgomery_ifma(__m512i b, __m512i e, __m512i n, __m512i ninv, __m512i r2)
+{
+    const __m512i um = _mm512_set1_epi64(1);
+    __m512i A = montgomery_ifma(b, r2, n, ninv),
+            P = montgomery_ifma(um, r2, n, ninv);
+
+    while (_mm512_test_epi64_mask(e, e)) {
+        P = _mm512_mask_mov_epi64(P, _mm512_test_epi64_mask(e, um), montgomery_ifma(A, P, n, ninv));
+        // maskz evita um falso aviso de variável não inicializada no gcc 12
+        e = _mm512_maskz_srli_epi64(0xff, e, 1);
+        A = montgomery_ifma(A, A, n, ninv);
+    }
+    return P;
+}
+
+IFMA static void mult_ifma(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n,
+                           const uint64_t *ninv, const uint64_t *r2)
+{
+    __m512i N = _mm512_loadu_si512(n),
+            I = _mm512_loadu_si512(ninv),
+            x;
+
+    x = montgomery_ifma(_mm512_loadu_si512(a), _mm512_loadu_si512(b), N, I);
+    x = montgomery_ifma(x, _mm512_loadu_si512(r2), N, I);
+    _mm512_storeu_si512(r, x);
+}
+
+IFMA static void exp_ifma(uint64_t *r, const uint64_t *b, const uint64_t *e, const uint64_t *n,
+                          const uint64_t *ninv, const uint64_t *r2)
+{
+    __m512i N = _mm512_loadu_si512(n),
+            I = _mm512_loadu_si512(ninv),
+            x;
+
+    x = exp_montgomery_ifma(_mm512_loadu_si512(b), _mm512_loadu_si512(e), N, I, _mm512_loadu_si512(r2));
+    x = montgomery_ifma(x, _mm512_set1_epi64(1), N, I);
+    _mm512_storeu_si512(r, x);
+}
+
+IFMA static void miller_ifma(bool *r, const uint64_t *b, const uint64_t *q, const uint64_t *k,
+                             const uint64_t *n, const uint64_t *ninv, const uint64_t *r2)
+{
+    __m512i N = _mm512_loadu_si512(n),
+            I = _mm512_loadu_si512(ninv),
+            R2 = _mm512_loadu_si512(r2),
+            K = _mm512_loadu_si512(k),
+            um = montgomery_ifma(_mm512_set1_epi64(1), R2, N, I),
+            n1 = _mm512_sub_epi64(N, um),
+            x;
+    __mmask8 res;
+    uint64_t kmax = 0;
+
+    x = exp_montgomery_ifma(_mm512_loadu_si512(b), _mm512_loadu_si512(q), N, I, R2);
+    res = _mm512_cmpeq_epi64_mask(x, um) | _mm512_cmpeq_epi64_mask(x, n1);
+    for (int i = 0; i < 8; i++) if (k[i] > kmax) kmax = k[i];
+    for (uint64_t i = 1; i < kmax; i++) {
+        x = montgomery_ifma(x, x, N, I);
+        res |= _mm512_cmpgt_epu64_mask(K, _mm512_set1_epi64(i)) & _mm512_cmpeq_epi64_mask(x, n1);
+    }
+    for (int i = 0; i < 8; i++) r[i] = (res >> i) & 1;
+}
+
+#endif // LOTE_X86
+
+/* ------------------------------ despacho ------------------------------- */
+
+// em ordem de preferência; a versão escalar deve ser sempre a última.
+static const kernel_lote kernels[] = {
+#ifdef LOTE_X86
+    {"avx512ifma", 8, 52, suportado_ifma, mult_ifma, exp_ifma, miller_ifma},
+    {"avx2", 4, 64, suportado_avx2, mult_avx2, exp_avx2, miller_avx2},
+#endif
+    {"escalar", 1, 64, suportado_escalar, mult_escalar, exp_escalar, miller_escalar},
+};
+
+#define N_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+// atômico porque as funções de lote são chamadas de várias threads (por exemplo
+// em verifica_certificados) e a primeira delas é quem escolhe o kernel
+static std::atomic<const kernel_lote*> kernel_escolhido(nullptr);
+
+static const kernel_lote *melhor_kernel(unsigned int bits_r)
+{
+    // primeiro kernel suportado pela CPU que aceite módulos de bits_r bits
+    for (size_t i = 0; i < N_KERNELS; i++) {
+        if (kernels[i].bits_r >= bits_r && kernels[i].suportado()) return &kernels[i];
+    }
+    return &kernels[N_KERNELS - 1];
+}
+
+static const kernel_lote *kernel_atual()
+{
+    const kernel_lote *kern = kernel_escolhido.load(std::memory_order_acquire);
+
+    if (kern == nullptr) {
+        // se outra thread escolher antes, compare_exchange devolve a escolha dela
+        const kernel_lote *melhor = melhor_kernel(0);
+        kern = nullptr;
+        if (kernel_escolhido.compare_exchange_strong(kern, melhor, std::memory_order_acq_rel)) kern = melhor;
+    }
+    return kern;
+}
+
+const char* implementacao_lote()
+{
+    // nome da implementação em uso: "avx512ifma", "avx2" ou "escalar"
+    return kernel_atual()->nome;
+}
+
+bool define_implementacao_lote(const char *nome)
+{
+    // força uma implementação (útil para testes). retorna false se ela não
+    // existe ou não é suportada pela CPU. não é thread-safe: deve ser chamada
+    // antes de qualquer outra thread usar as funções de lote, pois uma chamada
+    // em andamento pode misturar os dois kernels.
+    for (size_t i = 0; i < N_KERNELS; i++) {
+        if (strcmp(kernels[i].nome, nome) == 0 && kernels[i].suportado()) {
+            kernel_escolhido.store(&kernels[i], std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+static const kernel_lote *kernel_bloco(const uint64_t *n, size_t tam)
+{
+    // kernels de R < 2**64 só servem se todos os módulos do bloco couberem em R
+    const kernel_lote *kern = kernel_atual();
+
+    if (kern->bits_r == 64) return kern;
+    for (size_t i = 0; i < tam; i++) {
+        if (n[i] >> kern->bits_r) return melhor_kernel(64);
+    }
+    return kern;
+}
+
+static void prepara_bloco(const kernel_lote *kern, const uint64_t *n, uint64_t *ninv, uint64_t *r2)
+{
+    // calcula n^-1 (mod R) e R**2 (mod n) para cada módulo ímpar do bloco
+    uint64_t mascara = kern->bits_r == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << kern->bits_r) - 1,
+             r;
+
+    for (unsigned int i = 0; i < kern->largura; i++) {
+        ninv[i] = inverso_64(n[i]) & mascara;
+        r = kern->bits_r == 64 ? (0 - n[i]) % n[i] : ((uint64_t) 1 << kern->bits_r) % n[i];
+        r2[i] = mult_mod64(r, r, n[i]);
+    }
+}
+
+static bool montgomery_aceita(uint64_t n)
+{
+    return n > 1 && (n & 1);
+}
+
+static void verifica_modulos(const uint64_t *n, size_t tam)
+{
+    for (size_t i = 0; i < tam; i++) {
+        if (n[i] == 0) throw std::invalid_argument("os modulos devem ser diferentes de zero.");
+    }
+}
+
+static void mult_bloco(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n, size_t tam)
+{
+    const kernel_lote *kern = kernel_bloco(n, tam);
+    uint64_t aa[LARGURA_MAX], bb[LARGURA_MAX], nn[LARGURA_MAX], ninv[LARGURA_MAX],
+             r2[LARGURA_MAX], rr[LARGURA_MAX];
+
+    for (size_t i = 0; i < tam; i += kern->largura) {
+        size_t m = tam - i < kern->largura ? tam - i : kern->largura;
+        // posições que não servem para Montgomery (n par, n = 1) ou que
+        // completam o bloco recebem n = 3 e são resolvidas à parte
+        for (size_t j = 0; j < kern->largura; j++) {
+            bool ok = j < m && montgomery_aceita(n[i+j]);
+            nn[j] = ok ? n[i+j] : 3;
+            aa[j] = ok ? a[i+j] % n[i+j] : 0;
+            bb[j] = ok ? b[i+j] % n[i+j] : 0;
+        }
+        prepara_bloco(kern, nn, ninv, r2);
+        kern->mult(rr, aa, bb, nn, ninv, r2);
+        for (size_t j = 0; j < m; j++) {
+            r[i+j] = montgomery_aceita(n[i+j]) ? rr[j] : mult_mod64(a[i+j] % n[i+j], b[i+j] % n[i+j], n[i+j]);
+        }
+    }
+}
+
+void mult_modular_lote(uint64_t *r, const uint64_t *a, const uint64_t *b, const uint64_t *n, size_t tam)
+{
+    // r[i] = a[i] * b[i] (mod n[i]) para i em [0, tam)
+    verifica_modulos(n, tam);
+    for (size_t i = 0; i < tam; i += LARGURA_MAX) {
+        mult_bloco(r + i, a + i, b + i, n + i, tam - i < LARGURA_MAX ? tam - i : LARGURA_MAX);
+    }
+}
+
+static void exp_bloco(uint64_t *r, const uint64_t *b, const uint64_t *e, const uint64_t *n, size_t tam)
+{
+    const kernel_lote *kern = kernel_bloco(n, tam);
+    uint64_t bb[LARGURA_MAX], ee[LARGURA_MAX], nn[LARGURA_MAX], ninv[LARGURA_MAX],
+             r2[LARGURA_MAX], rr[LARGURA_MAX];
+
+    for (size_t i = 0; i < tam; i += kern->largura) {
+        size_t m = tam - i < kern->largura ? tam - i : kern->largura;
+        for (size_t j = 0; j < kern->largura; j++) {
+            bool ok = j < m && montgomery_aceita(n[i+j]);
+            nn[j] = ok ? n[i+j] : 3;
+            bb[j] = ok ? b[i+j] % n[i+j] : 0;
+            ee[j] = ok ? e[i+j] : 0;
+        }
+        prepara_bloco(kern, nn, ninv, r2);
+        kern->exp(rr, bb, ee, nn, ninv, r2);
+        for (size_t j = 0; j < m; j++) {
+            r[i+j] = montgomery_aceita(n[i+j]) ? rr[j] : exp_mod64(b[i+j], e[i+j], n[i+j]);
+        }
+    }
+}
+
+void exp_binaria_lote(uint64_t *r, const uint64_t *b, const uint64_t *e, const uint64_t *n, size_t tam)
+{
+    // r[i] = b[i]**e[i] (mod n[i]) para i em [0, tam)
+    verifica_modulos(n, tam);
+    for (size_t i = 0; i < tam; i += LARGURA_MAX) {
+        exp_bloco(r + i, b + i, e + i, n + i, tam - i < LARGURA_MAX ? tam - i : LARGURA_MAX);
+    }
+}
+
+static bool miller_trivial(uint64_t b, uint64_t n, bool &r)
+{
+    // casos que teste_miller resolve sem exponenciar
+    if (n == 2) { r = true; return true; }
+    if (n < 2 || n % 2 == 0) { r = false; return true; }
+    if (b % n == 0) { r = true; return true; }
+    return false;
+}
+
+static void miller_bloco(bool *r, const uint64_t *b, const uint64_t *n, size_t tam)
+{
+    const kernel_lote *kern = kernel_bloco(n, tam);
+    uint64_t bb[LARGURA_MAX], qq[LARGURA_MAX], kk[LARGURA_MAX], nn[LARGURA_MAX],
+             ninv[LARGURA_MAX], r2[LARGURA_MAX];
+    bool rr[LARGURA_MAX], trivial[LARGURA_MAX];
+
+    for (size_t i = 0; i < tam; i += kern->largura) {
+        size_t m = tam - i < kern->largura ? tam - i : kern->largura;
+        for (size_t j = 0; j < kern->largura; j++) {
+            trivial[j] = j >= m || miller_trivial(b[i+j], n[i+j], r[i+j]);
+            nn[j] = trivial[j] ? 3 : n[i+j];
+            bb[j] = trivial[j] ? 2 : b[i+j] % n[i+j];
+            // n - 1 = 2**k * q com q ímpar, como em pre_teste_miller
+            kk[j] = __builtin_ctzll(nn[j] - 1);
+            qq[j] = (nn[j] - 1) >> kk[j];
+        }
+        prepara_bloco(kern, nn, ninv, r2);
+        kern->miller(rr, bb, qq, kk, nn, ninv, r2);
+        for (size_t j = 0; j < m; j++) {
+            if (!trivial[j]) r[i+j] = rr[j];
+        }
+    }
+}
+
+void teste_miller_lote(bool *r, const uint64_t *b, const uint64_t *n, size_t tam)
+{
+    // versão em lote de teste_miller: r[i] é false se n[i] é CERTAMENTE
+    // composto na base b[i] e true se TALVEZ seja primo.
+    for (size_t i = 0; i < tam; i += LARGURA_MAX) {
+        miller_bloco(r + i, b + i, n + i, tam - i < LARGURA_MAX ? tam - i : LARGURA_MAX);
+    }
+}
+
+void primo_lote(bool *r, const uint64_t *n, size_t tam)
+{
+    // teste de primalidade determinístico para n < 2**64: Miller nessas sete
+    // bases não deixa passar nenhum composto de 64 bits. a cada base, apenas
+    // os candidatos que ainda não foram descartados seguem para a próxima.
+    static const uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    std::vector<size_t> vivos, proximos;
+    std::vector<uint64_t> nv, bv;
+    bool *res;
+
+    for (size_t i = 0; i < tam; i++) {
+        r[i] = true;
+        vivos.push_back(i);
+    }
+    res = new bool[tam > 0 ? tam : 1];
+    for (uint64_t base : bases) {
+        if (vivos.empty()) break;
+        nv.clear();
+        for (size_t i : vivos) nv.push_back(n[i]);
+        bv.assign(vivos.size(), base);
+        teste_miller_lote(res, bv.data(), nv.data(), nv.size());
+        proximos.clear();
+        for (size_t j = 0; j < vivos.size(); j++) {
+            if (res[j]) proximos.push_back(vivos[j]);
+            else r[vivos[j]] = false;
+        }
+        vivos.swap(proximos);
+    }
+    delete[] res;
+}
@@ -0,0 +1,14 @@
+#include <cstddef>
+#include <cstdint>
+
+void mult_modular_lote(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, size_t);
+
+void exp_binaria_lote(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, size_t);
+
+void teste_miller_lote(bool*, const uint64_t*, const uint64_t*, size_t);
+
+void primo_lote(bool*, const uint64_t*, size_t);
+
+const char* implementacao_lote();
+
+bool define_implementacao_lote(const char*);
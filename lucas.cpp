@@ -0,0 +1,169 @@
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "algoritmos.hpp"
+#include "lucas.hpp"
+
+/* Sequências de Lucas U(P, Q) e V(P, Q) por duplicação rápida:
+
+    U(0) = 0, U(1) = 1, U(k+2) = P U(k+1) - Q U(k)
+    V(k) = 2 U(k+1) - P U(k)
+
+Fibonacci é U(1, -1) e os números de Lucas são V(1, -1). Percorrendo os bits
+de n do mais significativo ao menos, o par (U(k), U(k+1)) vira (U(2k), U(2k+1))
+com
+
+    U(2k)   = U(k) (2 U(k+1) - P U(k))
+    U(2k+1) = U(k+1)^2 - Q U(k)^2
+
+e, se o bit for 1, avança mais um termo. São O(log n) passos com um número
+fixo de inteiros. Com m = 0 as contas são exatas; senão tudo é reduzido mod m
+com mult_modular, a mesma multiplicação de exp_binaria. */
+
+static mpz_class reduz(const mpz_class &x, const mpz_class &m)
+{
+    // x mod m no intervalo [0, m); com m = 0 devolve x
+    mpz_class r;
+
+    if (m == 0) return x;
+    r = x % m;
+    if (r < 0) r += m;
+    return r;
+}
+
+static mpz_class mult(const mpz_class &a, const mpz_class &b, const mpz_class &m)
+{
+    return m == 0 ? mpz_class(a * b) : mult_modular(a, b, m);
+}
+
+static void dobra_lucas(mpz_class &u, mpz_class &u1, mpz_class P, mpz_class Q, const mpz_class &n,
+                        const mpz_class &m)
+{
+    // ao fim, u = U(n) e u1 = U(n+1) (mod m, se m != 0)
+    mpz_class t, t1;
+
+    P = reduz(P, m);
+    Q = reduz(Q, m);
+    u = 0;
+    u1 = reduz(1, m);
+    for (long i = mpz_sizeinbase(n.get_mpz_t(), 2) - 1; i >= 0; i--) {
+        t = reduz(mult(u, 2 * u1 - P * u, m), m);
+        t1 = reduz(mult(u1, u1, m) - Q * mult(u, u, m), m);
+        if (mpz_tstbit(n.get_mpz_t(), i)) {
+            u = t1;
+            u1 = reduz(P * t1 - Q * t, m);
+        } else {
+            u = t;
+            u1 = t1;
+        }
+    }
+}
+
+mpz_class fibonacci(unsigned long n)
+{
+    // F(n) exato
+    mpz_class f, f1;
+
+    dobra_lucas(f, f1, 1, -1, n, 0);
+    return f;
+}
+
+mpz_class fibonacci_mod(mpz_class n, mpz_class m)
+{
+    // F(n) mod m, para n >= 0 e m > 0
+    mpz_class f, f1;
+
+    dobra_lucas(f, f1, 1, -1, n, m);
+    return f;
+}
+
+mpz_class numero_lucas(unsigned long n)
+{
+    // L(n) = 2 F(n+1) - F(n) exato
+    mpz_class f, f1;
+
+    dobra_lucas(f, f1, 1, -1, n, 0);
+    return 2 * f1 - f;
+}
+
+mpz_class numero_lucas_mod(mpz_class n, mpz_class m)
+{
+    // L(n) mod m, para n >= 0 e m > 0
+    mpz_class f, f1;
+
+    dobra_lucas(f, f1, 1, -1, n, m);
+    return reduz(2 * f1 - f, m);
+}
+
+void sequencia_lucas(mpz_class &U, mpz_class &V, mpz_class P, mpz_class Q, unsigned long n)
+{
+    // U = U(n) e V = V(n) exatos para os parâmetros P e Q
+    mpz_class u1;
+
+    dobra_lucas(U, u1, P, Q, n, 0);
+    V = 2 * u1 - P * U;
+}
+
+void sequencia_lucas_mod(mpz_class &U, mpz_class &V, mpz_class P, mpz_class Q, mpz_class n, mpz_class m)
+{
+    // U = U(n) mod m e V = V(n) mod m, para n >= 0 e m > 0
+    mpz_class u1;
+
+    dobra_lucas(U, u1, P, Q, n, m);
+    V = reduz(2 * u1 - P * U, m);
+}
+
+bool primo_lucas(mpz_class n)
+{
+    // teste forte de Lucas com os parâmetros de Selfridge: D é o primeiro de
+    // 5, -7, 9, -11, ... com (D/n) = -1, P = 1 e Q = (1 - D) / 4. escrevendo
+    // n + 1 = 2**s * d com d ímpar, n é provável primo se U(d) = 0 ou se
+    // V(d * 2**r) = 0 para algum 0 <= r < s (tudo mod n).
+    // retorna false se n é CERTAMENTE composto e true se TALVEZ seja primo.
+    mpz_class D = 5, Q, d, U, V, Qk;
+    unsigned long s;
+    int jacobi;
+
+    if (n == 2) return true;
+    if (n < 2 || n % 2 == 0) return false;
+    // quadrados perfeitos não têm D com (D/n) = -1
+    if (mpz_perfect_square_p(n.get_mpz_t())) return false;
+
+    while ((jacobi = mpz_jacobi(D.get_mpz_t(), n.get_mpz_t())) != -1) {
+        if (jacobi == 0 && abs(D) % n != 0) return false; // D tem fator comum com n
+        if (D > 0) D = -(D + 2);
+        else D = -(D - 2);
+    }
+    Q = (1 - D) / 4;
+
+    d = n + 1;
+    s = mpz_scan1(d.get_mpz_t(), 0);
+    d >>= s;
+
+    sequencia_lucas_mod(U, V, 1, Q, d, n);
+    if (U == 0 || V == 0) return true;
+
+    Qk = exp_binaria(reduz(Q, n), d, n);
+    for (unsigned long r = 1; r < s; r++) {
+        // V(2k) = V(k)^2 - 2 Q^k
+        V = reduz(mult_modular(V, V, n) - 2 * Qk, n);
+        if (V == 0) return true;
+        Qk = mult_modular(Qk, Qk, n);
+    }
+    return false;
+}
+
+bool primo_bpsw(mpz_class n)
+{
+    // Baillie-PSW: teste de Miller na base 2 seguido do teste forte de Lucas.
+    // não há composto conhecido que passe nos dois.
+    mpz_class n1, q;
+    unsigned int k;
+
+    if (n == 2) return true;
+    if (n < 2 || n % 2 == 0) return false;
+
+    pre_teste_miller(n, n1, k, q);
+    if (!teste_miller(2, n, n1, k, q)) return false;
+    return primo_lucas(n);
+}
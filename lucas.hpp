@@ -0,0 +1,15 @@
+mpz_class fibonacci(unsigned long);
+
+mpz_class fibonacci_mod(mpz_class, mpz_class);
+
+mpz_class numero_lucas(unsigned long);
+
+mpz_class numero_lucas_mod(mpz_class, mpz_class);
+
+void sequencia_lucas(mpz_class&, mpz_class&, mpz_class, mpz_class, unsigned long);
+
+void sequencia_lucas_mod(mpz_class&, mpz_class&, mpz_class, mpz_class, mpz_class, mpz_class);
+
+bool primo_lucas(mpz_class);
+
+bool primo_bpsw(mpz_class);
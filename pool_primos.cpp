@@ -0,0 +1,365 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "algoritmos.hpp"
+#include "pool_primos.hpp"
+
+/* Pool de primos prontos para gera_chaves. Threads em segundo plano mantêm
+uma fila por configuração (bits, seguro) entre as marcas baixa e alta; quem
+consome retira da fila sem bloquear e, se ela estiver vazia, gera o primo na
+hora. O estado é global, como o de um serviço: encerra_pool_primos não deve ser
+chamada ao mesmo tempo que retira_primo_pool.
+
+Um primo nunca pode ser entregue duas vezes, senão dois módulos RSA passam a
+ter um fator em comum. Por isso as sementes vêm de std::random_device (só
+inicia_pool_primos_teste usa sementes fixas) e o arquivo do pool é apagado
+assim que é carregado: se o processo terminar sem encerra_pool_primos, os
+primos que estavam na memória são perdidos em vez de reaproveitados. */
+
+class fila_primos {
+    // fila circular limitada sem locks (Vyukov) para vários produtores e
+    // consumidores. cada célula guarda um número de sequência que diz se ela
+    // está livre para escrita (seq == pos) ou pronta para leitura (seq == pos + 1).
+    struct celula {
+        std::atomic<size_t> seq;
+        mpz_class valor;
+    };
+
+    std::unique_ptr<celula[]> buffer;
+    size_t capacidade;
+    std::atomic<size_t> inicio, fim;
+
+public:
+    fila_primos(size_t cap) : buffer(new celula[cap]), capacidade(cap), inicio(0), fim(0)
+    {
+        for (size_t i = 0; i < cap; i++) buffer[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool insere(const mpz_class &x)
+    {
+        size_t pos = fim.load(std::memory_order_relaxed);
+        celula *c;
+
+        while (true) {
+            c = &buffer[pos % capacidade];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (fim.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (seq < pos) {
+                return false; // cheia
+            } else {
+                pos = fim.load(std::memory_order_relaxed);
+            }
+        }
+        c->valor = x;
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool retira(mpz_class &x)
+    {
+        size_t pos = inicio.load(std::memory_order_relaxed);
+        celula *c;
+
+        while (true) {
+            c = &buffer[pos % capacidade];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            if (seq == pos + 1) {
+                if (inicio.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (seq < pos + 1) {
+                return false; // vazia
+            } else {
+                pos = inicio.load(std::memory_order_relaxed);
+            }
+        }
+        x = c->valor;
+        c->seq.store(pos + capacidade, std::memory_order_release);
+        return true;
+    }
+
+    size_t tamanho() const
+    {
+        // aproximado enquanto houver threads mexendo na fila
+        size_t i = inicio.load(std::memory_order_relaxed),
+               f = fim.load(std::memory_order_relaxed);
+        return f > i ? f - i : 0;
+    }
+};
+
+struct entrada_pool {
+    config_pool config;
+    fila_primos fila;
+    std::atomic<bool> enchendo; // entre as marcas: true até atingir a alta
+    std::atomic<size_t> gerados, retirados, faltas, descartados;
+
+    entrada_pool(const config_pool &c)
+        : config(c), fila(c.capacidade), enchendo(true), gerados(0), retirados(0), faltas(0), descartados(0) {}
+};
+
+static std::vector<std::unique_ptr<entrada_pool>> entradas;
+static std::vector<std::thread> trabalhadores;
+static std::atomic<bool> parar(false);
+static std::mutex mutex_espera;
+static std::condition_variable espera;
+static std::chrono::steady_clock::time_point inicio_pool;
+static std::string arquivo_pool;
+
+static entrada_pool *busca_entrada(unsigned int bits, bool seguro)
+{
+    for (auto &e : entradas) {
+        if (e->config.bits == bits && e->config.seguro == seguro) return e.get();
+    }
+    return nullptr;
+}
+
+static entrada_pool *proxima_entrada()
+{
+    // a configuração mais vazia (proporcionalmente) entre as que estão enchendo
+    entrada_pool *melhor = nullptr;
+    double ocupacao, menor = 2;
+
+    for (auto &e : entradas) {
+        if (!e->enchendo.load()) continue;
+        ocupacao = double(e->fila.tamanho()) / e->config.capacidade;
+        if (ocupacao < menor) { menor = ocupacao; melhor = e.get(); }
+    }
+    return melhor;
+}
+
+static mpz_class semente_aleatoria()
+{
+    // 256 bits de std::random_device
+    std::random_device dispositivo;
+    mpz_class s = 0;
+
+    for (int i = 0; i < 8; i++) s = (s << 32) + (unsigned long) dispositivo();
+    return s;
+}
+
+static mpz_class primo_exato(unsigned int b, gmp_randclass &rnd)
+{
+    // como primo_aleatorio, mas com o bit mais alto ligado: exatamente b bits
+    mpz_class x;
+
+    do {
+        x = rnd.get_z_bits(b);
+        mpz_setbit(x.get_mpz_t(), b - 1);
+        x |= 1;
+    } while (!primo_miller_rabin(x, 20, rnd));
+    return x;
+}
+
+static bool primo_valido(const mpz_class &p, const config_pool &c, gmp_randclass &rnd)
+{
+    // true se p é um primo que a configuração c poderia ter gerado
+    size_t bits = mpz_sizeinbase(p.get_mpz_t(), 2);
+
+    if (p < 5) return false;
+    if (!c.seguro) return bits == c.bits && primo_miller_rabin(p, 20, rnd);
+    return bits <= c.bits + 1 && primo_miller_rabin(p, 20, rnd) && primo_miller_rabin((p - 1) / 2, 20, rnd);
+}
+
+static void trabalhador(mpz_class semente)
+{
+    // cada thread tem seu próprio gerador, pois gmp_randclass não é thread-safe
+    gmp_randclass rnd(gmp_randinit_default);
+    entrada_pool *e;
+    mpz_class p;
+
+    rnd.seed(semente);
+    while (!parar.load()) {
+        e = proxima_entrada();
+        if (e == nullptr) {
+            std::unique_lock<std::mutex> trava(mutex_espera);
+            espera.wait_for(trava, std::chrono::milliseconds(100),
+                            [] { return parar.load() || proxima_entrada() != nullptr; });
+            continue;
+        }
+        if (e->config.seguro) p = gera_primo_seguro(e->config.bits, rnd);
+        else p = primo_exato(e->config.bits, rnd);
+
+        if (e->fila.insere(p)) e->gerados++;
+        else e->descartados++;
+        if (e->fila.tamanho() >= e->config.marca_alta) e->enchendo = false;
+    }
+}
+
+static void carrega_pool(const char *arquivo)
+{
+    // formato: uma linha por primo com "bits seguro primo_em_hexadecimal".
+    // primos de configurações que não existem mais são ignorados, e cada valor
+    // é testado de novo antes de entrar na fila. o arquivo é apagado em seguida.
+    std::ifstream entrada(arquivo);
+    gmp_randclass rnd(gmp_randinit_default);
+    unsigned int bits;
+    bool seguro;
+    std::string hex;
+    entrada_pool *e;
+    mpz_class p;
+
+    if (!entrada) return;
+    rnd.seed(semente_aleatoria());
+    while (entrada >> bits >> seguro >> hex) {
+        e = busca_entrada(bits, seguro);
+        if (e == nullptr || p.set_str(hex, 16) != 0 || !primo_valido(p, e->config, rnd)) continue;
+        e->fila.insere(p);
+    }
+    entrada.close();
+    if (remove(arquivo) != 0) {
+        entradas.clear();
+        throw std::runtime_error("nao foi possivel apagar o arquivo do pool.");
+    }
+
+    for (auto &e : entradas) {
+        if (e->fila.tamanho() >= e->config.marca_alta) e->enchendo = false;
+    }
+}
+
+static void salva_pool(const char *arquivo)
+{
+    // ATENÇÃO: o arquivo guarda material de chaves futuras. é criado com
+    // permissão 0600 num arquivo temporário, que depois substitui o original
+    // com rename, para que nunca exista um arquivo pela metade.
+    std::ostringstream saida;
+    std::string conteudo, temporario = std::string(arquivo) + ".tmp";
+    mpz_class p;
+    ssize_t escritos;
+    size_t total = 0;
+    int fd;
+
+    for (auto &e : entradas) {
+        while (e->fila.retira(p)) {
+            saida << e->config.bits << ' ' << e->config.seguro << ' ' << p.get_str(16) << '\n';
+        }
+    }
+    conteudo = saida.str();
+
+    unlink(temporario.c_str());
+    fd = open(temporario.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) throw std::runtime_error("nao foi possivel criar o arquivo do pool.");
+    while (total < conteudo.size()) {
+        escritos = write(fd, conteudo.data() + total, conteudo.size() - total);
+        if (escritos <= 0) break;
+        total += escritos;
+    }
+    if (total != conteudo.size() || fsync(fd) != 0) {
+        close(fd);
+        unlink(temporario.c_str());
+        throw std::runtime_error("nao foi possivel gravar o arquivo do pool.");
+    }
+    close(fd);
+    if (rename(temporario.c_str(), arquivo) != 0) {
+        unlink(temporario.c_str());
+        throw std::runtime_error("nao foi possivel gravar o arquivo do pool.");
+    }
+}
+
+static void inicia(const std::vector<config_pool> &configs, unsigned int threads, const unsigned long *semente,
+                   const char *arquivo)
+{
+    if (!entradas.empty()) throw std::logic_error("o pool de primos ja foi iniciado.");
+
+    for (const config_pool &c : configs) {
+        if (c.bits < 2) throw std::invalid_argument("bits deve ser maior ou igual a 2.");
+        if (c.capacidade == 0 || c.marca_baixa > c.marca_alta || c.marca_alta > c.capacidade)
+            throw std::invalid_argument("marcas devem satisfazer marca_baixa <= marca_alta <= capacidade.");
+    }
+    for (const config_pool &c : configs) {
+        if (busca_entrada(c.bits, c.seguro) == nullptr) entradas.emplace_back(new entrada_pool(c));
+    }
+
+    arquivo_pool = arquivo != nullptr ? arquivo : "";
+    if (arquivo != nullptr) carrega_pool(arquivo);
+
+    parar = false;
+    inicio_pool = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < threads; i++) {
+        if (semente != nullptr) trabalhadores.emplace_back(trabalhador, mpz_class(*semente + i));
+        else trabalhadores.emplace_back(trabalhador, semente_aleatoria());
+    }
+}
+
+void inicia_pool_primos(const std::vector<config_pool> &configs, unsigned int threads, const char *arquivo)
+{
+    // inicia threads que mantêm primos prontos para cada configuração, cada uma
+    // com uma semente de std::random_device. se arquivo não for nulo, o pool é
+    // carregado dele agora (e o arquivo apagado) e salvo nele em encerra_pool_primos.
+    inicia(configs, threads, nullptr, arquivo);
+}
+
+void inicia_pool_primos_teste(const std::vector<config_pool> &configs, unsigned int threads, unsigned long semente,
+                              const char *arquivo)
+{
+    // só para testes: como inicia_pool_primos, mas a thread i usa a semente fixa
+    // semente + i, e portanto gera sempre os mesmos primos.
+    inicia(configs, threads, &semente, arquivo);
+}
+
+void encerra_pool_primos()
+{
+    // espera as threads terminarem o primo em andamento, salva o que sobrou na
+    // fila (se houver arquivo) e descarta o pool.
+    parar = true;
+    espera.notify_all();
+    for (auto &t : trabalhadores) t.join();
+    trabalhadores.clear();
+
+    try {
+        if (!arquivo_pool.empty()) salva_pool(arquivo_pool.c_str());
+    } catch (...) {
+        entradas.clear();
+        throw;
+    }
+    entradas.clear();
+}
+
+bool retira_primo_pool(mpz_class &p, unsigned int bits, bool seguro)
+{
+    // retira um primo pronto sem bloquear. retorna false se não houver pool
+    // para essa configuração ou se a fila estiver vazia.
+    entrada_pool *e = busca_entrada(bits, seguro);
+
+    if (e == nullptr) return false;
+    if (!e->fila.retira(p)) {
+        e->faltas++;
+        e->enchendo = true;
+        espera.notify_one();
+        return false;
+    }
+    e->retirados++;
+    if (e->fila.tamanho() < e->config.marca_baixa && !e->enchendo.exchange(true)) espera.notify_one();
+    return true;
+}
+
+metricas_pool metricas_pool_primos(unsigned int bits, bool seguro)
+{
+    metricas_pool m = {0, 0, 0, 0, 0, 0};
+    entrada_pool *e = busca_entrada(bits, seguro);
+    double segundos;
+
+    if (e == nullptr) return m;
+    segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_pool).count();
+    m.disponiveis = e->fila.tamanho();
+    m.gerados = e->gerados;
+    m.retirados = e->retirados;
+    m.faltas = e->faltas;
+    m.descartados = e->descartados;
+    m.taxa = segundos > 0 ? m.gerados / segundos : 0;
+    return m;
+}
@@ -0,0 +1,31 @@
+#include <cstddef>
+#include <vector>
+
+#include <gmpxx.h>
+
+struct config_pool {
+    unsigned int bits;   // tamanho exato dos primos comuns; parâmetro b de gera_primo_seguro nos seguros
+    bool seguro;         // true para primos seguros
+    size_t capacidade;   // máximo de primos guardados
+    size_t marca_baixa;  // abaixo disso as threads voltam a gerar
+    size_t marca_alta;   // a partir disso as threads param de gerar
+};
+
+struct metricas_pool {
+    size_t disponiveis;  // primos prontos na fila
+    size_t gerados;      // primos gerados pelas threads desde o início
+    size_t retirados;    // primos entregues por retira_primo_pool
+    size_t faltas;       // pedidos feitos com a fila vazia
+    size_t descartados;  // primos gerados com a fila já cheia
+    double taxa;         // primos gerados por segundo desde o início
+};
+
+void inicia_pool_primos(const std::vector<config_pool>&, unsigned int, const char* = nullptr);
+
+void inicia_pool_primos_teste(const std::vector<config_pool>&, unsigned int, unsigned long, const char* = nullptr);
+
+void encerra_pool_primos();
+
+bool retira_primo_pool(mpz_class&, unsigned int, bool);
+
+metricas_pool metricas_pool_primos(unsigned int, bool);
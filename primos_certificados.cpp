@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "algoritmos.hpp"
+#include "lote.hpp"
+#include "primos_certificados.hpp"
+#include "vetores.hpp"
+
+/* Primos provados com certificado (construção de Maurer / Shawe-Taylor).
+Um primo n de b bits é montado como n = 2Rq + 1 sobre um primo q já provado
+com q^2 > n, e o teorema de Pocklington prova n com uma única base a:
+
+    a^(n-1) = 1 (mod n)  e  mdc(a^((n-1)/q) - 1, n) = 1  =>  n é primo
+
+O custo é uma exponenciação por candidato, em vez das 20 a 40 do teste de
+Miller-Rabin, e o resultado é uma prova. A recursão termina em primos de até
+64 bits, provados pelo teste determinístico de primo_lote. O certificado é a
+cadeia de primos (do menor ao maior) com as bases usadas. */
+
+#define BITS_BASE 64      // primos até aqui são provados por primo_lote
+#define LIMITE_CRIVO 2000 // divisão por primos pequenos antes de exponenciar
+
+static const std::vector<unsigned long> &primos_pequenos()
+{
+    static const std::vector<unsigned long> primos = [] {
+        std::vector<bool> composto(LIMITE_CRIVO, false);
+        std::vector<unsigned long> r;
+        for (unsigned long i = 2; i < LIMITE_CRIVO; i++) {
+            if (composto[i]) continue;
+            r.push_back(i);
+            for (unsigned long j = i * i; j < LIMITE_CRIVO; j += i) composto[j] = true;
+        }
+        return r;
+    }();
+    return primos;
+}
+
+static bool tem_divisor_pequeno(const mpz_class &n)
+{
+    for (unsigned long p : primos_pequenos()) {
+        if (n == p) return false;
+        if (mpz_fdiv_ui(n.get_mpz_t(), p) == 0) return true;
+    }
+    return false;
+}
+
+static bool primo_base(const mpz_class &n)
+{
+    uint64_t x;
+    bool primo;
+
+    if (n < 2 || mpz_sizeinbase(n.get_mpz_t(), 2) > BITS_BASE) return false;
+    x = n.get_ui();
+    primo_lote(&primo, &x, 1);
+    return primo;
+}
+
+static bool prova_pocklington(const mpz_class &n, const mpz_class &q, unsigned long a)
+{
+    // verifica um passo do certificado: n = 2Rq + 1, q^2 > n e a prova com base a
+    mpz_class n1 = n - 1, b, g;
+
+    if (q < 2 || n <= q || q * q <= n || a < 2 || a >= n1) return false;
+    if (n1 % (2 * q) != 0) return false;
+
+    b = exp_binaria(a, n1 / q, n);
+    g = b - 1;
+    mpz_gcd(g.get_mpz_t(), g.get_mpz_t(), n.get_mpz_t());
+    return g == 1 && exp_binaria(b, q, n) == 1;
+}
+
+mpz_class primo_certificado(unsigned int b, gmp_randclass &rnd, certificado_primo *cert)
+{
+    // retorna um primo de exatamente b bits (b >= 2) e, se cert não for nulo,
+    // preenche-o com o certificado de primalidade.
+    mpz_class q, n, R, minimo, maximo;
+    certificado_primo local;
+
+    if (b < 2) throw std::invalid_argument("b deve ser maior ou igual a 2.");
+    if (cert == nullptr) cert = &local;
+
+    if (b <= BITS_BASE) {
+        do {
+            n = rnd.get_z_bits(b);
+            mpz_setbit(n.get_mpz_t(), b - 1);
+            n |= 1;
+        } while (!primo_base(n));
+        cert->assign(1, {n, 0});
+        return n;
+    }
+
+    // q com (b + 3) / 2 bits garante q^2 > 2^b > n
+    q = primo_certificado((b + 3) / 2, rnd, cert);
+
+    // R em [minimo, maximo] faz n = 2Rq + 1 ter exatamente b bits
+    minimo = ((mpz_class(1) << (b - 1)) - 1 + 2 * q - 1) / (2 * q);
+    maximo = ((mpz_class(1) << b) - 2) / (2 * q);
+    while (true) {
+        R = minimo + rnd.get_z_range(maximo - minimo + 1);
+        n = 2 * R * q + 1;
+        if (tem_divisor_pequeno(n)) continue;
+        if (prova_pocklington(n, q, 2)) break;
+    }
+    cert->push_back({n, 2});
+    return n;
+}
+
+static bool verifica_passos(const certificado_primo &c)
+{
+    for (size_t i = 1; i < c.size(); i++) {
+        if (!prova_pocklington(c[i].n, c[i-1].n, c[i].a)) return false;
+    }
+    return true;
+}
+
+bool verifica_certificado(const certificado_primo &c)
+{
+    // true se o certificado prova que c.back().n é primo
+    return !c.empty() && primo_base(c[0].n) && verifica_passos(c);
+}
+
+void verifica_certificados(bool *r, const std::vector<certificado_primo> &certs, unsigned int threads)
+{
+    // verifica vários certificados: os primos da base vão todos de uma vez para
+    // primo_lote e as cadeias de Pocklington são divididas entre as threads
+    // (0 = todos os núcleos).
+    std::vector<uint64_t> bases(certs.size(), 1);
+    std::vector<std::thread> trabalhadores;
+    std::atomic<size_t> proximo(0);
+
+    for (size_t i = 0; i < certs.size(); i++) {
+        if (!certs[i].empty() && certs[i][0].n >= 2 && mpz_sizeinbase(certs[i][0].n.get_mpz_t(), 2) <= BITS_BASE)
+            bases[i] = certs[i][0].n.get_ui();
+    }
+    primo_lote(r, bases.data(), bases.size());
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int t = 0; t < threads; t++) {
+        trabalhadores.emplace_back([&] {
+            size_t i;
+            while ((i = proximo++) < certs.size()) {
+                if (r[i]) r[i] = verifica_passos(certs[i]);
+            }
+        });
+    }
+    for (auto &t : trabalhadores) t.join();
+}
+
+void escreve_certificado(std::ostream &saida, const certificado_primo &c)
+{
+    // no formato de vetores.cpp, um vetor (n, a) por passo
+    mpz_class v[2];
+
+    escreve_cabecalho_vetores(saida, 2);
+    for (const passo_pocklington &p : c) {
+        v[0] = p.n;
+        v[1] = p.a;
+        escreve_vetor(saida, v, 2);
+    }
+}
+
+bool le_certificado(std::istream &entrada, certificado_primo &c)
+{
+    // lê um certificado gravado por escreve_certificado. retorna false se o
+    // arquivo não tiver o formato esperado.
+    mpz_class v[2];
+
+    c.clear();
+    try {
+        if (le_cabecalho_vetores(entrada) != 2) return false;
+        while (le_vetor(entrada, v, 2)) {
+            if (v[1] < 0 || !v[1].fits_ulong_p()) return false;
+            c.push_back({v[0], v[1].get_ui()});
+        }
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return !c.empty();
+}
@@ -0,0 +1,21 @@
+#include <iostream>
+#include <vector>
+
+#include <gmpxx.h>
+
+struct passo_pocklington {
+    mpz_class n;     // primo provado neste passo
+    unsigned long a; // base da prova de Pocklington (0 no primeiro passo)
+};
+
+typedef std::vector<passo_pocklington> certificado_primo;
+
+mpz_class primo_certificado(unsigned int, gmp_randclass&, certificado_primo* = nullptr);
+
+bool verifica_certificado(const certificado_primo&);
+
+void verifica_certificados(bool*, const std::vector<certificado_primo>&, unsigned int = 0);
+
+void escreve_certificado(std::ostream&, const certificado_primo&);
+
+bool le_certificado(std::istream&, certificado_primo&);
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "algoritmos.hpp"
+#include "pool_primos.hpp"
+#include "rsa_multiprimo.hpp"
+
+/* RSA com k primos (multi-prime RSA). O módulo n = p1 p2 ... pk tem o mesmo
+tamanho de uma chave de dois primos, mas cada primo tem só bits / k bits, o
+que barateia bastante a geração. A operação privada usa o teorema chinês do
+resto: M = C^d mod n sai de k exponenciações C^(d mod (pi - 1)) mod pi, com
+base, expoente e módulo k vezes menores, feitas em paralelo, e recombinadas
+pelo algoritmo de Garner. */
+
+#define EXPOENTE_PUBLICO 65537
+#define BITS_MINIMO_PRIMO 16 // abaixo disso não há primos distintos suficientes
+
+static bool primo_aceitavel(const mpz_class &p, const std::vector<mpz_class> &primos)
+{
+    // o primo não pode se repetir e e precisa ser inversível mod p - 1
+    return p > 2 && std::find(primos.begin(), primos.end(), p) == primos.end() && (p - 1) % EXPOENTE_PUBLICO != 0;
+}
+
+void gera_chaves_multiprimo(mpz_class &n, mpz_class &e, mpz_class &d, std::vector<mpz_class> &primos,
+                            unsigned int bits, unsigned int k, gmp_randclass &rnd)
+{
+    // gera a chave pública (n, e), com n de exatamente bits bits, e a privada
+    // (n, d) com os k primos de n em primos, para uso em descriptografa_crt.
+    // os k - 1 primeiros primos vêm do pool (se iniciado e não vazio) ou são
+    // gerados na hora; o último é sorteado no intervalo que completa os bits de n.
+    mpz_class p, minimo, maximo, lambda = 1;
+    unsigned int b;
+
+    if (k < 2) throw std::invalid_argument("k deve ser maior ou igual a 2.");
+    if (bits / k < BITS_MINIMO_PRIMO) throw std::invalid_argument("bits / k deve ser maior ou igual a 16.");
+
+    primos.clear();
+    n = 1;
+    for (unsigned int i = 0; i < k - 1; i++) {
+        b = bits / k;
+        do {
+            // primos do pool de outro tamanho (por exemplo, de um arquivo antigo) são descartados
+            if (!retira_primo_pool(p, b, false) || mpz_sizeinbase(p.get_mpz_t(), 2) != b) {
+                do {
+                    p = rnd.get_z_bits(b);
+                    mpz_setbit(p.get_mpz_t(), b - 1);
+                    p |= 1;
+                } while (!primo_miller_rabin(p, 20, rnd));
+            }
+        } while (!primo_aceitavel(p, primos));
+        primos.push_back(p);
+        n *= p;
+    }
+
+    // 2^(bits - 1) <= n p <= 2^bits - 1
+    minimo = ((mpz_class(1) << (bits - 1)) + n - 1) / n;
+    maximo = ((mpz_class(1) << bits) - 1) / n;
+    do {
+        p = minimo + rnd.get_z_range(maximo - minimo + 1);
+        p |= 1;
+    } while (p > maximo || !primo_aceitavel(p, primos) || !primo_miller_rabin(p, 20, rnd));
+    primos.push_back(p);
+    n *= p;
+
+    // d é o inverso de e mod lambda(n) = mmc(p1 - 1, ..., pk - 1)
+    for (const mpz_class &q : primos) {
+        p = q - 1;
+        mpz_lcm(lambda.get_mpz_t(), lambda.get_mpz_t(), p.get_mpz_t());
+    }
+    e = EXPOENTE_PUBLICO;
+    inverso_modular(d, e, lambda);
+}
+
+mpz_class descriptografa_crt(mpz_class C, const std::vector<mpz_class> &primos, mpz_class d, unsigned int threads)
+{
+    // retorna M = C**d % n, com n o produto de primos (distintos), fazendo uma
+    // exponenciação por primo em threads separadas (0 = todos os núcleos).
+    std::vector<mpz_class> residuos(primos.size());
+    std::vector<std::thread> trabalhadores;
+    std::atomic<size_t> proximo(0);
+    mpz_class M, produto, h, inverso;
+
+    if (primos.empty()) throw std::invalid_argument("a chave precisa de pelo menos um primo.");
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, primos.size());
+    for (unsigned int t = 0; t < threads; t++) {
+        trabalhadores.emplace_back([&] {
+            size_t i;
+            while ((i = proximo++) < primos.size()) {
+                const mpz_class &p = primos[i];
+                residuos[i] = exp_binaria(C % p, d % (p - 1), p);
+                if (residuos[i] < 0) residuos[i] += p;
+            }
+        });
+    }
+    for (auto &t : trabalhadores) t.join();
+
+    // Garner: M = m1 + h2 p1 + h3 p1 p2 + ..., com hi = (mi - M) / (p1 ... p(i-1)) mod pi
+    M = residuos[0];
+    produto = primos[0];
+    for (size_t i = 1; i < primos.size(); i++) {
+        const mpz_class &p = primos[i];
+        if (!inverso_modular(inverso, produto % p, p))
+            throw std::invalid_argument("os primos da chave devem ser distintos.");
+        h = (residuos[i] - M % p) * inverso % p;
+        if (h < 0) h += p;
+        M += h * produto;
+        produto *= p;
+    }
+    return M;
+}
@@ -0,0 +1,8 @@
+#include <vector>
+
+#include <gmpxx.h>
+
+void gera_chaves_multiprimo(mpz_class&, mpz_class&, mpz_class&, std::vector<mpz_class>&, unsigned int, unsigned int,
+                            gmp_randclass&);
+
+mpz_class descriptografa_crt(mpz_class, const std::vector<mpz_class>&, mpz_class, unsigned int = 0);
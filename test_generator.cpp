@@ -1,3 +1,4 @@
+#include <fstream>
 #include <iostream>
 #include <string.h>
 
@@ -5,6 +6,7 @@
 #include <gmp.h>
 
 #include "algoritmos.hpp"
+#include "vetores.hpp"
 
 #define N 20
 #define N_MUITO_LENTO 10
@@ -16,7 +18,7 @@ mpz_class erros;
 
 gmp_randclass r1(gmp_randinit_default);
 
-void testar_euclides_estendido()
+void testar_euclides_estendido(std::ostream &saida)
 {
     std::clog << "Testando euclides estendido...\n";
 
@@ -26,15 +28,12 @@ void testar_euclides_estendido()
         a = r1.get_z_bits(BITS);
         b = r1.get_z_bits(BITS);
         mpz_gcdext(mdc.get_mpz_t(), x.get_mpz_t(), y.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
-        std::cout << a << " ";
-        std::cout << b << " ";
-        std::cout << x << " ";
-        std::cout << y << " ";
-        std::cout << mdc << std::endl;
+        mpz_class v[] = {a, b, x, y, mdc};
+        escreve_vetor(saida, v, 5);
     }
 }
 
-void testar_inverso_modular()
+void testar_inverso_modular(std::ostream &saida)
 {
     std::clog << "Testando inverso modular...\n";
 
@@ -47,13 +46,12 @@ void testar_inverso_modular()
         if(n == 0) continue;
         invertivel = mpz_invert(inverso.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t());
         if (!invertivel) inverso = 0;
-        std::cout << a << " ";
-        std::cout << n << " ";
-        std::cout << inverso << std::endl;
+        mpz_class v[] = {a, n, inverso};
+        escreve_vetor(saida, v, 3);
     }   
 }
 
-void testar_exp_binaria()
+void testar_exp_binaria(std::ostream &saida)
 {
     std::clog << "Testando exponenciacao binaria...\n";
 
@@ -66,10 +64,8 @@ void testar_exp_binaria()
         n = r1.get_z_bits(BITS);
 
         mpz_powm(result.get_mpz_t(), b.get_mpz_t(), e.get_mpz_t(), n.get_mpz_t());
-        std::cout << b << " ";
-        std::cout << e << " ";
-        std::cout << n << " ";
-        std::cout << result << std::endl;
+        mpz_class v[] = {b, e, n, result};
+        escreve_vetor(saida, v, 4);
     }
 }
 
@@ -110,7 +106,7 @@ void testar_teste_miller()
     }
 }
 
-void testar_miller_rabin() 
+void testar_miller_rabin(std::ostream &saida)
 {
     std::clog << "Testando teste de miller-rabin...\n";
 
@@ -126,7 +122,8 @@ void testar_miller_rabin()
             std::cerr << "Erro: " << n << " teste Miller-Rabin esperado: " << resultado[1] << "; obtido: " << resultado[0] << '\n';
         }
         if (resultado[0] == resultado[1]) {
-            std::cout << n << " " << resultado[0] << std::endl;
+            mpz_class v[] = {n, resultado[0]};
+            escreve_vetor(saida, v, 2);
         }
     }
 }
@@ -141,7 +138,7 @@ void testar_primalidade_pequena()
     std::clog << '\n';
 }
 
-void testar_primo_aleatorio() 
+void testar_primo_aleatorio(std::ostream &saida)
 {
     std::clog << "Testando primo aleatorio...\n";
 
@@ -156,7 +153,8 @@ void testar_primo_aleatorio()
             i--;
             continue;
         }
-        std::cout << r << " " << 1 << std::endl;
+        mpz_class v[] = {r, 1};
+        escreve_vetor(saida, v, 2);
     }
 }
 
@@ -243,14 +241,24 @@ int main()
 {
     r1.seed(SEED);
     std::clog << "Testes iniciados com seed = " <<  SEED << '\n';
-    testar_euclides_estendido();
-    testar_exp_binaria();
-    testar_inverso_modular();
+    // os vetores são gravados no formato binário descrito em vetores.cpp
+    std::ofstream arq_extended_gcd("test/extended_gcd.vet", std::ios::binary),
+                  arq_exp_binaria("test/exp_binaria.vet", std::ios::binary),
+                  arq_inverso_modular("test/inverso_modular.vet", std::ios::binary),
+                  arq_primes("test/primes.vet", std::ios::binary);
+    escreve_cabecalho_vetores(arq_extended_gcd, 5);
+    escreve_cabecalho_vetores(arq_exp_binaria, 4);
+    escreve_cabecalho_vetores(arq_inverso_modular, 3);
+    escreve_cabecalho_vetores(arq_primes, 2);
+
+    testar_euclides_estendido(arq_extended_gcd);
+    testar_exp_binaria(arq_exp_binaria);
+    testar_inverso_modular(arq_inverso_modular);
     // testar_primalidade_pequena();
     // testar_primo_fermat();
     // testar_teste_miller();
-    testar_miller_rabin();
-    testar_primo_aleatorio();
+    testar_miller_rabin(arq_primes);
+    testar_primo_aleatorio(arq_primes);
     // testar_gera_chaves();
     // testar_codifica();
     // testar_decodifica();
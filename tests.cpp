@@ -1,10 +1,24 @@
 #include <iostream>
+#include <stdio.h>
 #include <string.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <sys/stat.h>
 
 #include <gmpxx.h>
 #include <gmp.h>
 
 #include "algoritmos.hpp"
+#include "fracoes_continuas.hpp"
+#include "lote.hpp"
+#include "lucas.hpp"
+#include "pool_primos.hpp"
+#include "primos_certificados.hpp"
+#include "rsa_multiprimo.hpp"
+#include "vetores.hpp"
 
 #define N 100
 #define N_MUITO_LENTO 10
@@ -154,6 +168,197 @@ void testar_primalidade_pequena()
     std::clog << '\n';
 }
 
+void testar_lucas()
+{
+    std::clog << "Testando sequencias de Lucas...\n";
+
+    // pseudoprimos fortes de Lucas: passam em primo_lucas, mas não em primo_bpsw
+    const unsigned long pseudoprimos[] = {5459, 5777, 10877, 16109, 18971};
+    mpz_class esperado, esperado1, m, n, P, Q, U, V, u[3];
+
+    for(unsigned long i=0; i<N_DETERMINISTICO; i++) {
+        mpz_fib_ui(esperado.get_mpz_t(), i);
+        mpz_lucnum_ui(esperado1.get_mpz_t(), i);
+        if(fibonacci(i) != esperado || numero_lucas(i) != esperado1) {
+            erros++;
+            std::cerr << "Erro: F(" << i << ") ou L(" << i << ") difere da GMP.\n";
+        }
+        m = r1.get_z_bits(64) + 1;
+        if(fibonacci_mod(i, m) != esperado % m || numero_lucas_mod(i, m) != esperado1 % m) {
+            erros++;
+            std::cerr << "Erro: F(" << i << ") ou L(" << i << ") mod " << m << " difere da GMP.\n";
+        }
+    }
+
+    for(int i=0; i<N; i++) {
+        // recorrência direta para P e Q pequenos (inclusive negativos)
+        P = mpz_class(r1.get_z_range(21)) - 10;
+        Q = mpz_class(r1.get_z_range(21)) - 10;
+        m = r1.get_z_bits(BITS) + 1;
+        u[0] = 0;
+        u[1] = 1;
+        for(unsigned long j=0; j<=200; j++) {
+            sequencia_lucas(U, V, P, Q, j);
+            if(U != u[0] || V != 2 * u[1] - P * u[0]) {
+                erros++;
+                std::cerr << "Erro: U/V(" << P << ", " << Q << ") em n = " << j << " difere da recorrencia.\n";
+                break;
+            }
+            u[2] = P * u[1] - Q * u[0];
+            u[0] = u[1];
+            u[1] = u[2];
+        }
+        n = r1.get_z_bits(BITS);
+        sequencia_lucas(U, V, P, Q, n.get_ui() % 5000);
+        esperado = U % m;
+        esperado1 = V % m;
+        if(esperado < 0) esperado += m;
+        if(esperado1 < 0) esperado1 += m;
+        sequencia_lucas_mod(U, V, P, Q, n.get_ui() % 5000, m);
+        if(U != esperado || V != esperado1) {
+            erros++;
+            std::cerr << "Erro: U/V(" << P << ", " << Q << ") mod " << m << " difere do exato.\n";
+        }
+    }
+
+    for(int i=0; i<N_DETERMINISTICO; i++) {
+        n = i < N_DETERMINISTICO / 2 ? mpz_class(i) : mpz_class(r1.get_z_bits(BITS));
+        if(primo_bpsw(n) != bool(mpz_probab_prime_p(n.get_mpz_t(), 20))) {
+            erros++;
+            std::cerr << "Erro: " << n << " teste BPSW obtido: " << primo_bpsw(n) << '\n';
+        }
+        if(mpz_probab_prime_p(n.get_mpz_t(), 20) && !primo_lucas(n)) {
+            erros++;
+            std::cerr << "Erro: primo " << n << " reprovado no teste de Lucas.\n";
+        }
+    }
+    for(unsigned long p : pseudoprimos) {
+        if(!primo_lucas(p) || primo_bpsw(p)) {
+            erros++;
+            std::cerr << "Erro: pseudoprimo de Lucas " << p << " classificado incorretamente.\n";
+        }
+    }
+}
+
+void testar_fracoes_continuas()
+{
+    std::clog << "Testando fracoes continuas...\n";
+
+    std::vector<mpz_class> periodo, termos;
+    mpz_class x, a0, h, k, h_seq[2], k_seq[2], aux;
+
+    for(int i=0; i<N; i++) {
+        // convergentes de sqrt(x) pela recorrência termo a termo
+        x = r1.get_z_bits(16); // o período de sqrt(x) cresce como sqrt(x)
+        a0 = fracao_continua_raiz(periodo, x);
+        if(periodo.empty()) {
+            if(a0 * a0 != x) {
+                erros++;
+                std::cerr << "Erro: " << x << " tem periodo vazio mas nao e quadrado.\n";
+            }
+            continue;
+        }
+        h_seq[0] = 1; h_seq[1] = a0;
+        k_seq[0] = 0; k_seq[1] = 1;
+        for(unsigned long n=1; n<=200; n++) {
+            const mpz_class &t = periodo[(n - 1) % periodo.size()];
+            aux = t * h_seq[1] + h_seq[0]; h_seq[0] = h_seq[1]; h_seq[1] = aux;
+            aux = t * k_seq[1] + k_seq[0]; k_seq[0] = k_seq[1]; k_seq[1] = aux;
+            if(n % 37 != 0 && n != 200) continue;
+            convergente_periodica(h, k, a0, periodo, n, 2);
+            if(h != h_seq[1] || k != k_seq[1]) {
+                erros++;
+                std::cerr << "Erro: convergente " << n << " de sqrt(" << x << ") difere da recorrencia.\n";
+            }
+        }
+        if(!solucao_pell(h, k, x) || h * h - x * k * k != 1) {
+            erros++;
+            std::cerr << "Erro: solucao de Pell invalida para D = " << x << '\n';
+        }
+    }
+
+    // a solução fundamental de x^2 - 61 y^2 = 1 é conhecida
+    if(!solucao_pell(h, k, 61) || h != 1766319049 || k != 226153980) {
+        erros++;
+        std::cerr << "Erro: solucao de Pell para D = 61: " << h << ", " << k << '\n';
+    }
+
+    // convergentes de e contra a recorrência
+    termos.push_back(2);
+    h_seq[0] = 1; h_seq[1] = 2;
+    k_seq[0] = 0; k_seq[1] = 1;
+    for(unsigned long n=1; n<=N_DETERMINISTICO; n++) {
+        termos.push_back(n % 3 == 2 ? 2 * ((n + 1) / 3) : 1);
+        aux = termos[n] * h_seq[1] + h_seq[0]; h_seq[0] = h_seq[1]; h_seq[1] = aux;
+        aux = termos[n] * k_seq[1] + k_seq[0]; k_seq[0] = k_seq[1]; k_seq[1] = aux;
+    }
+    convergente_e(h, k, N_DETERMINISTICO, 3);
+    if(h != h_seq[1] || k != k_seq[1]) {
+        erros++;
+        std::cerr << "Erro: convergente " << N_DETERMINISTICO << " de e difere da recorrencia.\n";
+    }
+    convergente(h, k, termos, 1);
+    if(h != h_seq[1] || k != k_seq[1]) {
+        erros++;
+        std::cerr << "Erro: convergente de termos finitos difere da recorrencia.\n";
+    }
+}
+
+void testar_primo_certificado()
+{
+    std::clog << "Testando primos certificados...\n";
+
+    const unsigned int bitagens[] = {2, 17, 64, 65, 128, 300, 512};
+    std::vector<certificado_primo> certificados;
+    certificado_primo cert, lido;
+    std::stringstream arquivo;
+    bool *resultado;
+    mpz_class p;
+
+    for(unsigned int bits : bitagens) {
+        p = primo_certificado(bits, r1, &cert);
+        if(mpz_sizeinbase(p.get_mpz_t(), 2) != bits || !mpz_probab_prime_p(p.get_mpz_t(), 20)) {
+            erros++;
+            std::cerr << "Erro: " << p << " nao e primo de " << bits << " bits.\n";
+        }
+        if(cert.back().n != p || !verifica_certificado(cert)) {
+            erros++;
+            std::cerr << "Erro: certificado de " << p << " rejeitado.\n";
+        }
+        certificados.push_back(cert);
+    }
+
+    // leitura e escrita
+    escreve_certificado(arquivo, certificados.back());
+    if(!le_certificado(arquivo, lido) || !verifica_certificado(lido) || lido.back().n != certificados.back().back().n) {
+        erros++;
+        std::cerr << "Erro: certificado lido difere do gravado.\n";
+    }
+
+    // certificados adulterados: base errada e n trocado por n + 2q (composto)
+    cert = certificados.back();
+    cert.back().a = 1;
+    certificados.push_back(cert);
+    cert = certificados[certificados.size() - 2];
+    do {
+        cert.back().n += 2 * cert[cert.size() - 2].n;
+    } while(mpz_probab_prime_p(cert.back().n.get_mpz_t(), 20));
+    certificados.push_back(cert);
+    cert = certificados[0];
+    cert[0].n = 15;
+    certificados.push_back(cert);
+
+    resultado = new bool[certificados.size()];
+    verifica_certificados(resultado, certificados, 3);
+    for(size_t i=0; i<certificados.size(); i++) {
+        if(resultado[i] != (i < sizeof(bitagens) / sizeof(bitagens[0]))) {
+            erros++;
+            std::cerr << "Erro: certificado " << i << " verificado em lote como " << resultado[i] << ".\n";
+        }
+    }
+    delete[] resultado;
+}
+
 void testar_primo_aleatorio() 
 {
     std::clog << "Testando primo aleatorio...\n";
@@ -181,6 +386,87 @@ void estimar_bitagem_primo_aleatorio()
     }
 }
 
+void testar_pool_primos()
+{
+    std::clog << "Testando pool de primos...\n";
+
+    const char *arquivo = "pool_primos_teste.txt";
+    std::vector<config_pool> configs = {{128, false, 8, 2, 6}, {32, true, 4, 1, 4}};
+    metricas_pool m;
+    struct stat info;
+    mpz_class p;
+
+    remove(arquivo);
+    inicia_pool_primos_teste(configs, 2, SEED, arquivo);
+    // espera a marca alta ser atingida (com limite de tempo)
+    for(int i=0; i<1000 && metricas_pool_primos(128, false).disponiveis < 6; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    for(int i=0; i<4; i++) {
+        if(!retira_primo_pool(p, 128, false)) {
+            erros++;
+            std::cerr << "Erro: pool vazio depois de atingir a marca alta.\n";
+        } else if(!mpz_probab_prime_p(p.get_mpz_t(), 20) || mpz_sizeinbase(p.get_mpz_t(), 2) != 128) {
+            erros++;
+            std::cerr << "Erro: " << p << " do pool nao e primo de 128 bits.\n";
+        }
+    }
+    for(int i=0; i<1000 && metricas_pool_primos(32, true).disponiveis == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if(retira_primo_pool(p, 32, true) && (!mpz_probab_prime_p(p.get_mpz_t(), 20) ||
+       !mpz_probab_prime_p(mpz_class((p - 1) / 2).get_mpz_t(), 20))) {
+        erros++;
+        std::cerr << "Erro: " << p << " do pool nao e primo seguro.\n";
+    }
+    if(retira_primo_pool(p, 64, false)) {
+        erros++;
+        std::cerr << "Erro: pool entregou primo de configuracao inexistente.\n";
+    }
+
+    m = metricas_pool_primos(128, false);
+    std::clog << "Pool: " << m.gerados << " gerados, " << m.retirados << " retirados, "
+        << m.faltas << " faltas, " << m.taxa << " primos/s.\n";
+    if(m.retirados != 4) {
+        erros++;
+        std::cerr << "Erro: metricas do pool contaram " << m.retirados << " retiradas.\n";
+    }
+
+    // o que sobrou deve voltar do arquivo sem precisar de threads; o arquivo
+    // é gravado com permissão 0600 e apagado ao ser carregado
+    encerra_pool_primos();
+    if(stat(arquivo, &info) != 0 || (info.st_mode & 0777) != 0600) {
+        erros++;
+        std::cerr << "Erro: " << arquivo << " nao foi gravado com permissao 0600.\n";
+    }
+    inicia_pool_primos(configs, 0, arquivo);
+    if(metricas_pool_primos(128, false).disponiveis == 0) {
+        erros++;
+        std::cerr << "Erro: pool nao foi recuperado de " << arquivo << ".\n";
+    }
+    if(stat(arquivo, &info) == 0) {
+        erros++;
+        std::cerr << "Erro: " << arquivo << " nao foi apagado depois de carregado.\n";
+    }
+    encerra_pool_primos();
+    remove(arquivo);
+
+    // valores que não são primos do tamanho configurado não entram na fila
+    p = primo_aleatorio(127, r1);
+    {
+        std::ofstream adulterado(arquivo);
+        adulterado << "128 0 " << mpz_class(p * 3).get_str(16) << '\n'  // composto
+                   << "128 0 " << p.get_str(16) << '\n'                  // tamanho errado
+                   << "128 0 xyz\n";
+    }
+    inicia_pool_primos(configs, 0, arquivo);
+    if(metricas_pool_primos(128, false).disponiveis != 0) {
+        erros++;
+        std::cerr << "Erro: pool aceitou valores invalidos de " << arquivo << ".\n";
+    }
+    encerra_pool_primos();
+    remove(arquivo);
+}
+
 void testar_gera_chaves()
 {
     mpz_class n, e, d; // chaves
@@ -203,6 +489,59 @@ void testar_gera_chaves()
     }
 }
 
+void testar_gera_chaves_multiprimo()
+{
+    const unsigned int tamanhos[][2] = {{512, 2}, {1024, 3}, {1024, 4}, {100, 5}};
+    std::vector<mpz_class> primos;
+    mpz_class n, e, d, produto, M, C;
+
+    std::clog << "Testando RSA com varios primos...\n";
+
+    for(auto &tamanho : tamanhos) {
+        gera_chaves_multiprimo(n, e, d, primos, tamanho[0], tamanho[1], r1);
+        produto = 1;
+        for(mpz_class &p : primos) {
+            produto *= p;
+            if(!mpz_probab_prime_p(p.get_mpz_t(), 20)) {
+                erros++;
+                std::cerr << "Erro: " << p << " nao e primo.\n";
+            }
+        }
+        if(primos.size() != tamanho[1] || produto != n || mpz_sizeinbase(n.get_mpz_t(), 2) != tamanho[0]) {
+            erros++;
+            std::cerr << "Erro: chave de " << tamanho[0] << " bits com " << tamanho[1] << " primos invalida.\n";
+        }
+        for(int j=0; j<N; j++) {
+            M = j < 2 ? mpz_class(j) : mpz_class(r1.get_z_range(n));
+            C = criptografa(M, n, e);
+            if(descriptografa_crt(C, primos, d, j % 3) != M || descriptografa(C, n, d) != M) {
+                erros++;
+                std::cerr << "Erro: descriptografa_crt falhou com M = " << M << '\n';
+                break;
+            }
+        }
+    }
+
+    // com o pool ligado, os k - 1 primeiros primos continuam com bits / k bits
+    inicia_pool_primos_teste({{256, false, 8, 2, 8}}, 2, SEED);
+    for(int i=0; i<1000 && metricas_pool_primos(256, false).disponiveis < 8; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for(int i=0; i<3; i++) {
+        gera_chaves_multiprimo(n, e, d, primos, 1024, 4, r1);
+        for(int j=0; j<3; j++) {
+            if(mpz_sizeinbase(primos[j].get_mpz_t(), 2) != 256) {
+                erros++;
+                std::cerr << "Erro: primo " << primos[j] << " da chave nao tem 256 bits.\n";
+            }
+        }
+    }
+    if(metricas_pool_primos(256, false).retirados == 0) {
+        erros++;
+        std::cerr << "Erro: gera_chaves_multiprimo nao usou o pool.\n";
+    }
+    encerra_pool_primos();
+}
+
 void testar_codifica()
 {
     mpz_class M;
@@ -244,6 +583,106 @@ void testar_criptografia_completa()
 
 }
 
+void testar_lote()
+{
+    const char *implementacoes[] = {"escalar", "avx2", "avx512ifma"};
+    const unsigned int bitagens[] = {20, 52, 64};
+    uint64_t a[N_DETERMINISTICO], b[N_DETERMINISTICO], n[N_DETERMINISTICO], r[N_DETERMINISTICO];
+    bool miller[N_DETERMINISTICO], primo[N_DETERMINISTICO];
+    mpz_class esperado, n1, q;
+    unsigned int k;
+
+    for(const char *nome : implementacoes) {
+        if(!define_implementacao_lote(nome)) continue;
+        std::clog << "Testando aritmetica em lote (" << nome << ")...\n";
+
+        for(unsigned int bits : bitagens) {
+            for(int i=0; i<N_DETERMINISTICO; i++) {
+                a[i] = mpz_class(r1.get_z_bits(bits)).get_ui();
+                b[i] = mpz_class(r1.get_z_bits(bits)).get_ui();
+                n[i] = mpz_class(r1.get_z_bits(bits)).get_ui();
+                if(n[i] == 0) n[i] = 1;
+                if(i % 2) n[i] |= 1; // metade dos módulos ímpares
+            }
+
+            mult_modular_lote(r, a, b, n, N_DETERMINISTICO);
+            for(int i=0; i<N_DETERMINISTICO; i++) {
+                esperado = mpz_class(a[i]) * mpz_class(b[i]) % mpz_class(n[i]);
+                if(r[i] != esperado.get_ui()) {
+                    erros++;
+                    std::cerr << "Erro: " << a[i] << " * " << b[i] << " mod " << n[i] << " = " << esperado
+                        << ", mas o calculado foi " << r[i] << ".\n";
+                }
+            }
+
+            exp_binaria_lote(r, a, b, n, N_DETERMINISTICO);
+            for(int i=0; i<N_DETERMINISTICO; i++) {
+                mpz_powm(esperado.get_mpz_t(), mpz_class(a[i]).get_mpz_t(), mpz_class(b[i]).get_mpz_t(),
+                         mpz_class(n[i]).get_mpz_t());
+                if(r[i] != esperado.get_ui()) {
+                    erros++;
+                    std::cerr << "Erro: " << a[i] << "^" << b[i] << " mod " << n[i] << " = " << esperado
+                        << ", mas o calculado foi " << r[i] << ".\n";
+                }
+            }
+
+            teste_miller_lote(miller, a, n, N_DETERMINISTICO);
+            primo_lote(primo, n, N_DETERMINISTICO);
+            for(int i=0; i<N_DETERMINISTICO; i++) {
+                if(n[i] > 2 && n[i] % 2 == 1 && a[i] != 0) {
+                    pre_teste_miller(n[i], n1, k, q);
+                    if(miller[i] != teste_miller(a[i], n[i], n1, k, q)) {
+                        erros++;
+                        std::cerr << "Erro: " << n[i] << " com base " << a[i] << "; miller em lote: " << miller[i] << '\n';
+                    }
+                }
+                if(primo[i] != bool(mpz_probab_prime_p(mpz_class(n[i]).get_mpz_t(), 20))) {
+                    erros++;
+                    std::cerr << "Erro: " << n[i] << " primo em lote: " << primo[i] << '\n';
+                }
+            }
+        }
+    }
+}
+
+void testar_vetores()
+{
+    std::clog << "Testando formato binario de vetores...\n";
+
+    // o mesmo gerador é semeado duas vezes para refazer os vetores na leitura
+    gmp_randclass r2(gmp_randinit_default);
+    std::stringstream arquivo;
+    mpz_class v[3], lido[3];
+
+    r2.seed(SEED);
+    escreve_cabecalho_vetores(arquivo, 3);
+    for(int i=0; i<N; i++) {
+        v[0] = r2.get_z_bits(BITS);
+        v[1] = -mpz_class(r2.get_z_bits(i));
+        v[2] = i;
+        escreve_vetor(arquivo, v, 3);
+    }
+
+    r2.seed(SEED);
+    if(le_cabecalho_vetores(arquivo) != 3) {
+        erros++;
+        std::cerr << "Erro: numero de campos lido difere do gravado.\n";
+    }
+    for(int i=0; i<N; i++) {
+        v[0] = r2.get_z_bits(BITS);
+        v[1] = -mpz_class(r2.get_z_bits(i));
+        v[2] = i;
+        if(!le_vetor(arquivo, lido, 3) || lido[0] != v[0] || lido[1] != v[1] || lido[2] != v[2]) {
+            erros++;
+            std::cerr << "Erro: vetor " << i << " lido difere do gravado.\n";
+        }
+    }
+    if(le_vetor(arquivo, lido, 3)) {
+        erros++;
+        std::cerr << "Erro: vetor extra lido depois do fim.\n";
+    }
+}
+
 void testar_gerar_primo_seguro()
 {
     std::cout << gera_primo_seguro(8, r1) << '\n';
@@ -260,12 +699,19 @@ int main()
     testar_primo_fermat();
     testar_teste_miller();
     testar_miller_rabin();
+    testar_lote();
+    testar_lucas();
+    testar_fracoes_continuas();
+    testar_primo_certificado();
     testar_primo_aleatorio();
+    testar_pool_primos();
     testar_gera_chaves();
+    testar_gera_chaves_multiprimo();
     testar_codifica();
     testar_decodifica();
     testar_criptografia_completa();
     testar_gerar_primo_seguro();
+    testar_vetores();
 
     // estimar_bitagem_primo_aleatorio();
     std::clog << erros << " erro(s) encontrado(s).\n";
@@ -2,25 +2,34 @@ import pytest
 
 import tp
 
-extgcd = []
-with open("test/extended_gcd.txt") as file:
-    for line in file:
-        extgcd.append([int(x) for x in line.split()])
-
-fastexp = []
-with open("test/exp_binaria.txt") as file:
-    for line in file:
-        fastexp.append([int(x) for x in line.split()])
-
-invmod = []
-with open("test/inverso_modular.txt") as file:
-    for line in file:
-        invmod.append([int(x) for x in line.split()])
-
-primes = []
-with open("test/primes.txt") as file:
-    for line in file:
-        primes.append([int(x) for x in line.split()])
+def read_vectors(path):
+    # reads the binary vector format described in vetores.cpp
+    with open(path, "rb") as file:
+        data = file.read()
+    if data[:4] != b"NTV1":
+        raise ValueError(f"{path} is not a vector file.")
+    fields, pos, out = data[4], 5, []
+    while pos < len(data):
+        row = []
+        for _ in range(fields):
+            header, shift = 0, 0
+            while True:
+                byte = data[pos]
+                pos += 1
+                header |= (byte & 0x7f) << shift
+                shift += 7
+                if not byte & 0x80: break
+            size = header >> 1
+            x = int.from_bytes(data[pos:pos + size], "little")
+            pos += size
+            row.append(-x if header & 1 else x)
+        out.append(row)
+    return out
+
+extgcd = read_vectors("test/extended_gcd.vet")
+fastexp = read_vectors("test/exp_binaria.vet")
+invmod = read_vectors("test/inverso_modular.vet")
+primes = read_vectors("test/primes.vet")
 
 @pytest.mark.parametrize("n,r", [
     [1, 1],
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include "vetores.hpp"
+
+/* Formato binário dos vetores de teste (test/<nome>.vet):
+
+    cabeçalho: "NTV1" seguido de 1 byte com o número de campos por vetor
+    vetores:   até o fim do arquivo, cada um com esse número de inteiros
+
+Cada inteiro é um varint (LEB128) com (tamanho_em_bytes << 1) | negativo,
+seguido do módulo em bytes little-endian. O zero ocupa um único byte. */
+
+static const char MAGICO[4] = {'N', 'T', 'V', '1'};
+
+static void escreve_varint(std::ostream &saida, size_t x)
+{
+    do {
+        unsigned char byte = x & 0x7f;
+        x >>= 7;
+        if (x != 0) byte |= 0x80;
+        saida.put(byte);
+    } while (x != 0);
+}
+
+static bool le_varint(std::istream &entrada, size_t &x)
+{
+    int byte;
+    unsigned int desloc = 0;
+
+    x = 0;
+    do {
+        byte = entrada.get();
+        if (byte == EOF) return false;
+        x |= size_t(byte & 0x7f) << desloc;
+        desloc += 7;
+    } while (byte & 0x80);
+    return true;
+}
+
+void escreve_cabecalho_vetores(std::ostream &saida, unsigned int campos)
+{
+    if (campos == 0 || campos > 255) throw std::invalid_argument("campos deve estar entre 1 e 255.");
+    saida.write(MAGICO, 4);
+    saida.put(campos);
+}
+
+void escreve_vetor(std::ostream &saida, const mpz_class *v, unsigned int campos)
+{
+    // escreve os campos inteiros de v
+    std::vector<unsigned char> bytes;
+    size_t tam;
+
+    for (unsigned int i = 0; i < campos; i++) {
+        bytes.resize((mpz_sizeinbase(v[i].get_mpz_t(), 2) + 7) / 8);
+        mpz_export(bytes.data(), &tam, -1, 1, 0, 0, v[i].get_mpz_t());
+        escreve_varint(saida, tam << 1 | (v[i] < 0));
+        saida.write((const char*) bytes.data(), tam);
+    }
+}
+
+unsigned int le_cabecalho_vetores(std::istream &entrada)
+{
+    // retorna o número de campos por vetor
+    char magico[4];
+    int campos;
+
+    entrada.read(magico, 4);
+    campos = entrada.get();
+    if (!entrada || std::string(magico, 4) != std::string(MAGICO, 4) || campos <= 0)
+        throw std::runtime_error("arquivo de vetores invalido.");
+    return campos;
+}
+
+bool le_vetor(std::istream &entrada, mpz_class *v, unsigned int campos)
+{
+    // lê o próximo vetor em v. retorna false no fim do arquivo.
+    std::vector<unsigned char> bytes;
+    size_t cab;
+
+    for (unsigned int i = 0; i < campos; i++) {
+        if (!le_varint(entrada, cab)) {
+            if (i == 0) return false;
+            throw std::runtime_error("vetor truncado.");
+        }
+        bytes.resize(cab >> 1);
+        entrada.read((char*) bytes.data(), bytes.size());
+        if (!entrada) throw std::runtime_error("vetor truncado.");
+        mpz_import(v[i].get_mpz_t(), bytes.size(), -1, 1, 0, 0, bytes.data());
+        if (cab & 1) v[i] = -v[i];
+    }
+    return true;
+}
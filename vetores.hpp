@@ -0,0 +1,11 @@
+#include <iostream>
+
+#include <gmpxx.h>
+
+void escreve_cabecalho_vetores(std::ostream&, unsigned int);
+
+void escreve_vetor(std::ostream&, const mpz_class*, unsigned int);
+
+unsigned int le_cabecalho_vetores(std::istream&);
+
+bool le_vetor(std::istream&, mpz_class*, unsigned int);